@@ -0,0 +1,336 @@
+#include "augmenter.h"
+#include <algorithm> // For std::shuffle, std::min, std::max
+#include <cmath>     // For sin, cos, floor, exp
+#include <iostream>
+
+// The constructor
+// Goal : remember where the data lives, prepare the epoch order and start the workers
+Augmenter::Augmenter(const std::vector<unsigned char> &pixels, int rows, int cols,
+                     const AugmentConfig &config, int batch_size, int epochs,
+                     int num_workers, int queue_depth, unsigned seed)
+    : pixels(pixels),
+      rows(rows),
+      cols(cols),
+      count(0),
+      config(config),
+      batch_size(std::max(1, batch_size)),
+      queue_depth(std::max(1, queue_depth)),
+      total_batches(0),
+      shuffle_rng(seed),
+      next_batch(0),
+      delivered(0),
+      stopping(false)
+{
+    if (rows <= 0 || cols <= 0 || pixels.size() % (size_t)(rows * cols) != 0)
+    {
+        std::cerr << "Error : Augmenter got an image buffer that does not match rows x cols." << std::endl;
+        return; // total_batches stays 0, next() returns false right away
+    }
+    count = (int)(pixels.size() / (size_t)(rows * cols));
+    total_batches = batchesPerEpoch() * std::max(0, epochs);
+
+    order.resize(count);
+    for (int i = 0; i < count; i++)
+        order[i] = i;
+
+    // Elastic field smoothing kernel
+    // Random per-pixel displacements are just noise; blurring them with a gaussian
+    // turns them into smooth "rubber sheet" warps, which is what handwriting looks like.
+    if (this->config.elastic_alpha > 0.0)
+    {
+        double sigma = std::max(0.5, this->config.elastic_sigma);
+        int radius = (int)std::ceil(3.0 * sigma); // 3 sigma covers 99.7% of the bell
+        double sum = 0.0;
+        for (int k = -radius; k <= radius; k++)
+        {
+            double w = std::exp(-(k * k) / (2.0 * sigma * sigma));
+            elastic_kernel.push_back((float)w);
+            sum += w;
+        }
+        for (float &w : elastic_kernel)
+            w = (float)(w / sum); // Normalize so the taps add up to 1
+    }
+
+    // One core stays with the training loop, the rest warp images
+    if (num_workers <= 0)
+    {
+        int hw = (int)std::thread::hardware_concurrency();
+        num_workers = std::max(1, hw - 1);
+    }
+    for (int w = 0; w < num_workers; w++)
+    {
+        workers.emplace_back(&Augmenter::workerLoop, this, seed + 1 + w);
+    }
+}
+
+Augmenter::~Augmenter()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    space_cv.notify_all();
+    ready_cv.notify_all();
+    for (std::thread &t : workers)
+        t.join();
+}
+
+int Augmenter::batchesPerEpoch() const
+{
+    return (count + batch_size - 1) / batch_size; // Round up, last batch may be short
+}
+
+// Worker Loop
+/*
+    1. Claim the next batch id and copy its sample indices (under the lock)
+       The first batch of every epoch reshuffles the order.
+    2. Warp every image of the batch (no lock, this is the expensive part)
+    3. Wait for room in the ready queue and publish the batch
+*/
+void Augmenter::workerLoop(unsigned seed)
+{
+    std::mt19937 rng(seed);     // Every worker has its own generator, no sharing
+    std::vector<float> scratch; // Reused for every image this worker touches
+    AugmentedBatch work;
+    int pixel_count = rows * cols;
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (stopping || next_batch >= total_batches)
+                break;
+
+            int position = next_batch % batchesPerEpoch();
+            next_batch++;
+            if (position == 0)
+            {
+                std::shuffle(order.begin(), order.end(), shuffle_rng);
+            }
+
+            // Grab a recycled buffer so we do not allocate every batch
+            if (work.images.empty() && !spare.empty())
+            {
+                work = std::move(spare.back());
+                spare.pop_back();
+            }
+
+            int start = position * batch_size;
+            work.size = std::min(batch_size, count - start);
+            work.indices.assign(order.begin() + start, order.begin() + start + work.size);
+        }
+
+        work.images.resize(work.size);
+        for (int b = 0; b < work.size; b++)
+        {
+            work.images[b].resize(pixel_count);
+            const unsigned char *src = pixels.data() + (size_t)work.indices[b] * pixel_count;
+            augmentOne(src, work.images[b].data(), rng, scratch);
+        }
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            space_cv.wait(guard, [this] { return stopping || (int)ready.size() < queue_depth; });
+            if (stopping)
+                break;
+            ready.push_back(std::move(work));
+            work = AugmentedBatch();
+        }
+        ready_cv.notify_one();
+    }
+}
+
+bool Augmenter::next(AugmentedBatch &batch)
+{
+    AugmentedBatch incoming;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (delivered >= total_batches)
+            return false;
+
+        ready_cv.wait(guard, [this] { return stopping || !ready.empty(); });
+        if (ready.empty())
+            return false;
+
+        incoming = std::move(ready.front());
+        ready.pop_front();
+        delivered++;
+
+        // Hand the caller's old buffers back to the workers
+        std::swap(batch, incoming);
+        if (!incoming.images.empty())
+            spare.push_back(std::move(incoming));
+    }
+    space_cv.notify_one();
+    return true;
+}
+
+// Augment One Image
+/*
+    Inverse warp with bilinear sampling.
+
+    Forward transform (what happens to the digit):
+        p' = Scale * Rotate * (p - center) + center + shift
+    We need the opposite direction (which source pixel lands on output pixel p'):
+        p  = Rotate^-1 * Scale^-1 * (p' - center - shift) + center
+
+    To let the compiler vectorize, every row is done in separate flat passes:
+        a. source coordinates for the whole row (pure arithmetic, SIMD friendly)
+        b. split into integer corner + fractional weight (SIMD friendly)
+        c. gather the 4 corners and blend
+    The source is copied into a float image with a zero border (1 pixel on the top / left,
+    2 on the bottom / right so the clamped corner's +1 neighbour is still zero), and
+    coordinates are clamped into that border, so step c has no bounds checks at all.
+*/
+void Augmenter::augmentOne(const unsigned char *src, double *dst, std::mt19937 &rng,
+                           std::vector<float> &scratch)
+{
+    const int n = rows * cols;
+    const int pw = cols + 3; // Padded width  (1 zero column left, 2 right)
+    const int ph = rows + 3; // Padded height (1 zero row on top, 2 below)
+
+    // Scratch layout : padded source | dx | dy | blur temp | row x | row y | row weights
+    scratch.resize((size_t)pw * ph + 3 * n + 4 * cols);
+    float *padded = scratch.data();
+    float *dx = padded + pw * ph;
+    float *dy = dx + n;
+    float *tmp = dy + n;
+    float *row_x = tmp + n;
+    float *row_y = row_x + cols;
+    float *frac_x = row_y + cols;
+    float *frac_y = frac_x + cols;
+
+    // 1. Padded float copy of the source (0-255 -> 0.0-1.0)
+    std::fill(padded, padded + pw * ph, 0.0f);
+    for (int y = 0; y < rows; y++)
+    {
+        float *prow = padded + (y + 1) * pw + 1;
+        const unsigned char *srow = src + y * cols;
+        for (int x = 0; x < cols; x++)
+            prow[x] = srow[x] * (1.0f / 255.0f);
+    }
+
+    // 2. Random affine parameters for this image
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    const double pi = 3.14159265358979323846;
+    double shift_x = unit(rng) * config.max_shift;
+    double shift_y = unit(rng) * config.max_shift;
+    double angle = unit(rng) * config.max_rotation * pi / 180.0;
+    double scale = 1.0 + unit(rng) * config.max_scale;
+
+    // Inverse matrix = Rotate(-angle) / scale
+    float a = (float)(std::cos(angle) / scale);
+    float b = (float)(std::sin(angle) / scale);
+    float cx = (cols - 1) * 0.5f;
+    float cy = (rows - 1) * 0.5f;
+
+    // 3. Optional elastic field
+    bool elastic = config.elastic_alpha > 0.0 && !elastic_kernel.empty();
+    if (elastic)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            dx[i] = (float)unit(rng);
+            dy[i] = (float)unit(rng);
+        }
+        int radius = (int)elastic_kernel.size() / 2;
+        float alpha = (float)config.elastic_alpha;
+
+        // Separable blur : horizontal into tmp, vertical back into the field
+        // Edges are clamped (the pixel at the border repeats)
+        float *fields[2] = {dx, dy};
+        for (float *field : fields)
+        {
+            for (int y = 0; y < rows; y++)
+            {
+                for (int x = 0; x < cols; x++)
+                {
+                    float sum = 0.0f;
+                    for (int k = -radius; k <= radius; k++)
+                    {
+                        int xx = std::min(cols - 1, std::max(0, x + k));
+                        sum += elastic_kernel[k + radius] * field[y * cols + xx];
+                    }
+                    tmp[y * cols + x] = sum;
+                }
+            }
+            for (int y = 0; y < rows; y++)
+            {
+                for (int x = 0; x < cols; x++)
+                {
+                    float sum = 0.0f;
+                    for (int k = -radius; k <= radius; k++)
+                    {
+                        int yy = std::min(rows - 1, std::max(0, y + k));
+                        sum += elastic_kernel[k + radius] * tmp[yy * cols + x];
+                    }
+                    field[y * cols + x] = sum * alpha;
+                }
+            }
+        }
+    }
+
+    // 4. Warp row by row
+    const float lo_x = -1.0f, hi_x = (float)cols; // Clamp range lands in the zero border
+    const float lo_y = -1.0f, hi_y = (float)rows;
+    for (int y = 0; y < rows; y++)
+    {
+        float v = y - cy - (float)shift_y;
+
+        // a. Source coordinates (linear in x, so this loop is pure SIMD arithmetic)
+        for (int x = 0; x < cols; x++)
+        {
+            float u = x - cx - (float)shift_x;
+            row_x[x] = a * u + b * v + cx;
+            row_y[x] = -b * u + a * v + cy;
+        }
+        if (elastic)
+        {
+            const float *ex = dx + y * cols;
+            const float *ey = dy + y * cols;
+            for (int x = 0; x < cols; x++)
+            {
+                row_x[x] += ex[x];
+                row_y[x] += ey[x];
+            }
+        }
+
+        // b. Clamp, shift into padded coordinates, split into corner + weight
+        for (int x = 0; x < cols; x++)
+        {
+            float sx = std::min(hi_x, std::max(lo_x, row_x[x])) + 1.0f;
+            float sy = std::min(hi_y, std::max(lo_y, row_y[x])) + 1.0f;
+            float fx = std::floor(sx);
+            float fy = std::floor(sy);
+            frac_x[x] = sx - fx;
+            frac_y[x] = sy - fy;
+            row_x[x] = fx; // Reuse the coordinate arrays for the integer corner
+            row_y[x] = fy;
+        }
+
+        // c. Gather and blend the 4 neighbours
+        double *out = dst + y * cols;
+        for (int x = 0; x < cols; x++)
+        {
+            int x0 = (int)row_x[x];
+            int y0 = (int)row_y[x];
+            const float *p = padded + y0 * pw + x0;
+            float fx = frac_x[x];
+            float fy = frac_y[x];
+            float top = p[0] + fx * (p[1] - p[0]);
+            float bottom = p[pw] + fx * (p[pw + 1] - p[pw]);
+            out[x] = top + fy * (bottom - top);
+        }
+    }
+
+    // 5. Optional noise, kept inside the valid pixel range
+    if (config.noise_stddev > 0.0)
+    {
+        std::normal_distribution<double> noise(0.0, config.noise_stddev);
+        for (int i = 0; i < n; i++)
+        {
+            double val = dst[i] + noise(rng);
+            dst[i] = std::min(1.0, std::max(0.0, val));
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef AUGMENTER_H
+#define AUGMENTER_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+
+/*
+    The Problem : One pass over MNIST is not enough, but more passes over the
+    exact same 60,000 images just memorizes them.
+    Data augmentation shows the network a slightly different version of every
+    digit each time (shifted, rotated, stretched, wobbly, noisy) so it has to
+    learn the SHAPE of a digit instead of its exact pixels.
+
+    Storing those extra versions would cost another 60000 x 784 doubles per epoch.
+    Instead the Augmenter builds them on the fly:
+    - It reads the raw uint8 images (MNISTParser::loadImagesRaw), 8x smaller than doubles
+    - A pool of worker threads warps images into batches while the main thread trains
+    - Finished batches wait in a small bounded queue, so memory never grows
+      (queue_depth + workers + 1 batches exist at most, and they are recycled)
+
+    Every augmentation is a single inverse warp:
+    for every OUTPUT pixel (x, y) we ask "where in the SOURCE image did this come from?"
+    and read the source with bilinear interpolation (blend of the 4 nearest pixels).
+    Affine part (shift / rotate / scale) + optional elastic displacement field,
+    then optional gaussian noise on top.
+*/
+
+struct AugmentConfig {
+    double max_shift = 2.0;       // Pixels, uniform in [-max_shift, max_shift] per axis
+    double max_rotation = 10.0;   // Degrees, uniform in [-max_rotation, max_rotation]
+    double max_scale = 0.1;       // Zoom factor in [1 - max_scale, 1 + max_scale]
+    double elastic_alpha = 0.0;   // Strength of elastic distortion in pixels (0 = off)
+    double elastic_sigma = 4.0;   // Smoothness of the elastic field (gaussian blur sigma)
+    double noise_stddev = 0.0;    // Additive gaussian pixel noise (0 = off)
+};
+
+// One ready-to-train batch
+// images[b] is a normalized (0.0-1.0) image, indices[b] is its position in the dataset
+// (use it to look up the label). The last batch of an epoch can be shorter.
+struct AugmentedBatch {
+    std::vector<std::vector<double>> images;
+    std::vector<int> indices;
+    int size = 0;
+};
+
+class Augmenter {
+private:
+    // 1. Source Data (not owned, must outlive the Augmenter)
+    const std::vector<unsigned char> &pixels;
+    int rows, cols, count;
+
+    // 2. Settings
+    AugmentConfig config;
+    int batch_size;
+    int queue_depth;
+    int total_batches;            // Over all epochs
+    std::vector<float> elastic_kernel; // 1D gaussian taps for the elastic field
+
+    // 3. Work distribution (guarded by lock)
+    std::mutex lock;
+    std::condition_variable ready_cv;  // Consumer waits for a ready batch
+    std::condition_variable space_cv;  // Workers wait for room in the queue
+    std::deque<AugmentedBatch> ready;  // Finished batches
+    std::vector<AugmentedBatch> spare; // Recycled buffers from the consumer
+    std::vector<int> order;            // Shuffled sample order for the current epoch
+    std::mt19937 shuffle_rng;
+    int next_batch;                    // Next batch id to hand to a worker
+    int delivered;                     // Batches handed to the consumer
+    bool stopping;
+
+    std::vector<std::thread> workers;
+
+    void workerLoop(unsigned seed);
+    void augmentOne(const unsigned char *src, double *dst, std::mt19937 &rng,
+                    std::vector<float> &scratch);
+
+public:
+    // Starts the workers right away, they produce `epochs` passes over the dataset
+    Augmenter(const std::vector<unsigned char> &pixels, int rows, int cols,
+              const AugmentConfig &config, int batch_size, int epochs,
+              int num_workers = 0, int queue_depth = 4, unsigned seed = 42);
+    ~Augmenter();
+
+    Augmenter(const Augmenter &) = delete;
+    Augmenter &operator=(const Augmenter &) = delete;
+
+    // Blocks until a batch is ready and swaps it into `batch`.
+    // The old contents of `batch` are recycled, so keep passing the same object.
+    // Returns false once every epoch has been delivered.
+    bool next(AugmentedBatch &batch);
+
+    int batchesPerEpoch() const;
+};
+
+#endif // AUGMENTER_H
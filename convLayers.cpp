@@ -0,0 +1,467 @@
+#include "convLayers.h"
+#include "threadPool.h"
+#include <algorithm> // For std::max, std::min, std::fill
+#include <cmath>     // For sqrt
+#include <iostream>
+
+// ReLU Activation
+// Negative sums become 0, positive ones pass through unchanged
+static double relu(double x) {
+    return x > 0.0 ? x : 0.0;
+}
+
+// Derivative of ReLU, from the OUTPUT (like dsigmoid) : slope 1 where it fired, else 0
+static double drelu(double y) {
+    return y > 0.0 ? 1.0 : 0.0;
+}
+
+// Helper : split `rows` independent rows over the shared pool (same grain as the Matrix kernels)
+template <typename RowBody>
+static void forRows(int rows, long ops_per_row, RowBody body) {
+    long grain_rows = std::max(1L, Matrix::getParallelGrain() / std::max(1L, ops_per_row));
+    ThreadPool::global().parallelFor(rows, grain_rows, [&](long begin, long end) {
+        body((int)begin, (int)end);
+    });
+}
+
+static bool checkShape(ConstMatrixView v, int rows, int cols, const char *what) {
+    if (v.rows != rows || v.cols != cols) {
+        std::cerr << "Error: " << what << " is " << v.rows << "x" << v.cols
+                  << ", expected " << rows << "x" << cols << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// CONV2D
+
+Conv2D::Conv2D(int in_channels, int in_height, int in_width, int out_channels, int kernel,
+               int stride, int padding)
+    : in_channels(in_channels), in_height(in_height), in_width(in_width),
+      out_channels(out_channels), kernel(kernel), stride(std::max(1, stride)), padding(padding),
+      out_height((in_height + 2 * padding - kernel) / std::max(1, stride) + 1),
+      out_width((in_width + 2 * padding - kernel) / std::max(1, stride) + 1),
+      learning_rate(0.01),
+      algorithm(ConvAlgorithm::Auto),
+      weights(out_channels, in_channels * kernel * kernel),
+      bias(out_channels, 1)
+{
+    if (out_height <= 0 || out_width <= 0) {
+        std::cerr << "Error: Conv2D kernel " << kernel << " does not fit a "
+                  << in_height << "x" << in_width << " input." << std::endl;
+        out_height = out_width = 0;
+    }
+    // Random weights in -1..1, shrunk by the number of inputs per filter
+    // (sqrt(6 / fan_in) keeps the size of the outputs steady from layer to layer with ReLU)
+    weights.randomize();
+    double limit = std::sqrt(6.0 / std::max(1, in_channels * kernel * kernel));
+    Matrix::multiplyScalar(weights.view(), limit, weights.view());
+}
+
+// Direct path only for stride 1 and dense rows (pointer walks along each row)
+static bool denseRows(ConstMatrixView v) {
+    return v.data == nullptr || v.col_stride == 1;
+}
+
+bool Conv2D::useDirect() const {
+    if (stride != 1) return false;
+    if (algorithm == ConvAlgorithm::Auto) return kernel == 3;
+    return algorithm == ConvAlgorithm::Direct;
+}
+
+// IM2COL
+// Row (c, ky, kx) of cols, column (oy, ox) = input pixel under filter tap (ky, kx)
+// at output position (oy, ox), or 0 where the filter hangs over the padding
+void Conv2D::im2col(ConstMatrixView input, MatrixView cols) const {
+    int positions = out_height * out_width;
+    forRows(in_channels * kernel * kernel, positions, [&](int first, int last) {
+        for (int r = first; r < last; r++) {
+            int c = r / (kernel * kernel);
+            int ky = (r / kernel) % kernel;
+            int kx = r % kernel;
+            for (int oy = 0; oy < out_height; oy++) {
+                int iy = oy * stride - padding + ky;
+                for (int ox = 0; ox < out_width; ox++) {
+                    int ix = ox * stride - padding + kx;
+                    bool inside = iy >= 0 && iy < in_height && ix >= 0 && ix < in_width;
+                    cols.at(r, oy * out_width + ox) = inside ? input.at(c, iy * in_width + ix) : 0.0;
+                }
+            }
+        }
+    });
+}
+
+// COL2IM : the reverse, ADDING every column entry back onto the pixel it came from
+// (a pixel sits under up to k*k filter taps, so it collects up to k*k errors)
+// Split by channel : every piece owns whole rows of input_errors
+void Conv2D::col2im(ConstMatrixView cols, MatrixView input_errors) const {
+    forRows(in_channels, (long)kernel * kernel * out_height * out_width, [&](int first, int last) {
+        for (int c = first; c < last; c++) {
+            for (int i = 0; i < in_height * in_width; i++) input_errors.at(c, i) = 0.0;
+            for (int ky = 0; ky < kernel; ky++) {
+                for (int kx = 0; kx < kernel; kx++) {
+                    int r = (c * kernel + ky) * kernel + kx;
+                    for (int oy = 0; oy < out_height; oy++) {
+                        int iy = oy * stride - padding + ky;
+                        if (iy < 0 || iy >= in_height) continue;
+                        for (int ox = 0; ox < out_width; ox++) {
+                            int ix = ox * stride - padding + kx;
+                            if (ix < 0 || ix >= in_width) continue;
+                            input_errors.at(c, iy * in_width + ix) += cols.at(r, oy * out_width + ox);
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+// DIRECT PATH (stride 1)
+/*
+    For every filter tap (ky, kx) the whole output row moves in step with an input row:
+        out[oy][ox] += w * in[oy - pad + ky][ox - pad + kx]
+    so the inner loop is a plain "row += w * row" the compiler turns into SIMD.
+    The only work per tap is finding the x range that stays inside the image.
+    With K known at compile time (3), the tap loops unroll completely.
+*/
+template <int K>
+static void slideFilters(const double *w, const double *in, double *out, int kernel_runtime,
+                         int in_height, int in_width, int out_height, int out_width, int padding) {
+    const int kernel = K > 0 ? K : kernel_runtime;
+    for (int ky = 0; ky < kernel; ky++) {
+        for (int kx = 0; kx < kernel; kx++) {
+            double weight = w[ky * kernel + kx];
+            int x0 = std::max(0, padding - kx);
+            int x1 = std::min(out_width, in_width + padding - kx);
+            for (int oy = 0; oy < out_height; oy++) {
+                int iy = oy - padding + ky;
+                if (iy < 0 || iy >= in_height) continue;
+                const double *in_row = in + iy * in_width - padding + kx;
+                double *out_row = out + oy * out_width;
+                for (int ox = x0; ox < x1; ox++) {
+                    out_row[ox] += weight * in_row[ox];
+                }
+            }
+        }
+    }
+}
+
+void Conv2D::forwardDirect(ConstMatrixView input, MatrixView output) const {
+    int positions = out_height * out_width;
+    forRows(out_channels, (long)positions * in_channels * kernel * kernel, [&](int first, int last) {
+        for (int oc = first; oc < last; oc++) {
+            double *out = &output.at(oc, 0);
+            std::fill(out, out + positions, bias.at(oc, 0));
+            for (int ic = 0; ic < in_channels; ic++) {
+                const double *w = &weights.at(oc, ic * kernel * kernel);
+                const double *in = &input.at(ic, 0);
+                if (kernel == 3) {
+                    slideFilters<3>(w, in, out, kernel, in_height, in_width, out_height, out_width, padding);
+                } else {
+                    slideFilters<0>(w, in, out, kernel, in_height, in_width, out_height, out_width, padding);
+                }
+            }
+            for (int p = 0; p < positions; p++) out[p] = relu(out[p]);
+        }
+    });
+}
+
+// Backward of the direct path : the same slide, read the other way round
+// input_errors[ic] += w * gradients[oc] (shifted back), weight_deltas = sum of gradient * input
+void Conv2D::backwardDirect(ConstMatrixView input, ConstMatrixView gradients, MatrixView input_errors,
+                            Matrix &weight_deltas) const {
+    long work_per_channel = (long)out_height * out_width * kernel * kernel;
+
+    if (input_errors.data) {
+        forRows(in_channels, work_per_channel * out_channels, [&](int first, int last) {
+            for (int ic = first; ic < last; ic++) {
+                double *err = &input_errors.at(ic, 0);
+                std::fill(err, err + in_height * in_width, 0.0);
+                for (int oc = 0; oc < out_channels; oc++) {
+                    const double *grad = &gradients.at(oc, 0);
+                    for (int ky = 0; ky < kernel; ky++) {
+                        for (int kx = 0; kx < kernel; kx++) {
+                            double weight = weights.at(oc, (ic * kernel + ky) * kernel + kx);
+                            int x0 = std::max(0, padding - kx);
+                            int x1 = std::min(out_width, in_width + padding - kx);
+                            for (int oy = 0; oy < out_height; oy++) {
+                                int iy = oy - padding + ky;
+                                if (iy < 0 || iy >= in_height) continue;
+                                double *err_row = err + iy * in_width - padding + kx;
+                                const double *grad_row = grad + oy * out_width;
+                                for (int ox = x0; ox < x1; ox++) {
+                                    err_row[ox] += weight * grad_row[ox];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    forRows(out_channels, work_per_channel * in_channels, [&](int first, int last) {
+        for (int oc = first; oc < last; oc++) {
+            const double *grad = &gradients.at(oc, 0);
+            for (int ic = 0; ic < in_channels; ic++) {
+                const double *in = &input.at(ic, 0);
+                for (int ky = 0; ky < kernel; ky++) {
+                    for (int kx = 0; kx < kernel; kx++) {
+                        int x0 = std::max(0, padding - kx);
+                        int x1 = std::min(out_width, in_width + padding - kx);
+                        double sum = 0.0;
+                        for (int oy = 0; oy < out_height; oy++) {
+                            int iy = oy - padding + ky;
+                            if (iy < 0 || iy >= in_height) continue;
+                            const double *in_row = in + iy * in_width - padding + kx;
+                            const double *grad_row = grad + oy * out_width;
+                            for (int ox = x0; ox < x1; ox++) {
+                                sum += grad_row[ox] * in_row[ox];
+                            }
+                        }
+                        weight_deltas.at(oc, (ic * kernel + ky) * kernel + kx) = sum;
+                    }
+                }
+            }
+        }
+    });
+}
+
+bool Conv2D::forward(ConstMatrixView input, MatrixView output) const {
+    int positions = out_height * out_width;
+    if (!checkShape(input, in_channels, in_height * in_width, "Conv2D input")) return false;
+    if (!checkShape(output, out_channels, positions, "Conv2D output")) return false;
+
+    if (useDirect() && denseRows(input) && denseRows(output)) {
+        forwardDirect(input, output);
+        return true;
+    }
+
+    // im2col, then every filter at every position in one multiply
+    Matrix cols(in_channels * kernel * kernel, positions);
+    im2col(input, cols.view());
+    Matrix::multiply(weights.view(), cols.view(), output);
+    Matrix::addColumn(output, bias.view(), output);
+    Matrix::map(output, relu, output);
+    return true;
+}
+
+bool Conv2D::backward(ConstMatrixView input, ConstMatrixView output, ConstMatrixView output_errors,
+                      MatrixView input_errors) {
+    int positions = out_height * out_width;
+    if (!checkShape(input, in_channels, in_height * in_width, "Conv2D input")) return false;
+    if (!checkShape(output, out_channels, positions, "Conv2D output")) return false;
+    if (!checkShape(output_errors, out_channels, positions, "Conv2D output error")) return false;
+    if (input_errors.data && !checkShape(input_errors, in_channels, in_height * in_width, "Conv2D input error")) {
+        return false;
+    }
+
+    // Gradient = error * drelu(output) (only outputs that fired pass their error on)
+    Matrix gradients(out_channels, positions);
+    Matrix::map(output, drelu, gradients.view());
+    Matrix::multiplyHadamard(gradients.view(), output_errors, gradients.view());
+
+    // Input errors (through the old weights) and filter nudges
+    Matrix weight_deltas(out_channels, in_channels * kernel * kernel);
+    if (useDirect() && denseRows(input) && denseRows(input_errors)) {
+        backwardDirect(input, gradients.view(), input_errors, weight_deltas);
+    } else {
+        if (input_errors.data) {
+            // Error of every patch entry = WEIGHTS_T * GRADIENT, then fold patches back onto pixels
+            Matrix col_errors(in_channels * kernel * kernel, positions);
+            Matrix::multiply(weights.view().transposed(), gradients.view(), col_errors.view());
+            col2im(col_errors.view(), input_errors);
+        }
+        // Nudge = GRADIENT * COLS_T : every position a filter visited adds its share
+        Matrix cols(in_channels * kernel * kernel, positions);
+        im2col(input, cols.view());
+        Matrix::multiply(gradients.view(), cols.view().transposed(), weight_deltas.view());
+    }
+
+    // Gradient descent : weights += learning_rate * nudge, bias += learning_rate * summed gradient
+    Matrix::multiplyScalar(weight_deltas.view(), learning_rate, weight_deltas.view());
+    Matrix::add(weights.view(), weight_deltas.view(), weights.view());
+    for (int oc = 0; oc < out_channels; oc++) {
+        double sum = 0.0;
+        for (int p = 0; p < positions; p++) sum += gradients.at(oc, p);
+        bias.at(oc, 0) += learning_rate * sum;
+    }
+    return true;
+}
+
+// MAXPOOL2D
+
+MaxPool2D::MaxPool2D(int channels, int in_height, int in_width, int size)
+    : channels(channels), in_height(in_height), in_width(in_width), size(std::max(1, size)),
+      out_height(in_height / std::max(1, size)), out_width(in_width / std::max(1, size))
+{
+    // Leftover rows / columns that do not fill a whole block are dropped (like floor division)
+}
+
+bool MaxPool2D::forward(ConstMatrixView input, MatrixView output) const {
+    if (!checkShape(input, channels, in_height * in_width, "MaxPool2D input")) return false;
+    if (!checkShape(output, channels, out_height * out_width, "MaxPool2D output")) return false;
+
+    for (int c = 0; c < channels; c++) {
+        for (int py = 0; py < out_height; py++) {
+            for (int px = 0; px < out_width; px++) {
+                double best = input.at(c, (py * size) * in_width + px * size);
+                for (int y = py * size; y < (py + 1) * size; y++) {
+                    for (int x = px * size; x < (px + 1) * size; x++) {
+                        best = std::max(best, input.at(c, y * in_width + x));
+                    }
+                }
+                output.at(c, py * out_width + px) = best;
+            }
+        }
+    }
+    return true;
+}
+
+bool MaxPool2D::backward(ConstMatrixView input, ConstMatrixView output_errors, MatrixView input_errors) const {
+    if (!checkShape(input, channels, in_height * in_width, "MaxPool2D input")) return false;
+    if (!checkShape(output_errors, channels, out_height * out_width, "MaxPool2D output error")) return false;
+    if (!checkShape(input_errors, channels, in_height * in_width, "MaxPool2D input error")) return false;
+
+    for (int c = 0; c < channels; c++) {
+        for (int i = 0; i < in_height * in_width; i++) input_errors.at(c, i) = 0.0;
+        for (int py = 0; py < out_height; py++) {
+            for (int px = 0; px < out_width; px++) {
+                // Find the winner again (first one on a tie, like forward)
+                int winner = (py * size) * in_width + px * size;
+                for (int y = py * size; y < (py + 1) * size; y++) {
+                    for (int x = px * size; x < (px + 1) * size; x++) {
+                        if (input.at(c, y * in_width + x) > input.at(c, winner)) winner = y * in_width + x;
+                    }
+                }
+                input_errors.at(c, winner) += output_errors.at(c, py * out_width + px);
+            }
+        }
+    }
+    return true;
+}
+
+// CONVNET
+
+int ConvNet::flatSize(int channels, int height, int width, const std::vector<ConvStage> &stages) {
+    for (const ConvStage &s : stages) {
+        channels = s.filters;
+        height = height + 2 * s.padding - s.kernel + 1;
+        width = width + 2 * s.padding - s.kernel + 1;
+        if (s.pool > 1) {
+            height /= s.pool;
+            width /= s.pool;
+        }
+    }
+    return std::max(0, channels * height * width);
+}
+
+ConvNet::ConvNet(int channels, int height, int width, const std::vector<ConvStage> &stages,
+                 int hidden_nodes, int output_nodes, OutputHead output_head)
+    : channels(channels), height(height), width(width),
+      head(flatSize(channels, height, width, stages), hidden_nodes, output_nodes, output_head)
+{
+    int c = channels, h = height, w = width;
+    for (const ConvStage &s : stages) {
+        convs.emplace_back(c, h, w, s.filters, s.kernel, 1, s.padding);
+        c = s.filters;
+        h = convs.back().getOutHeight();
+        w = convs.back().getOutWidth();
+        pools.emplace_back(c, h, w, std::max(1, s.pool));
+        pooled.push_back(s.pool > 1);
+        if (s.pool > 1) {
+            h = pools.back().getOutHeight();
+            w = pools.back().getOutWidth();
+        }
+    }
+}
+
+void ConvNet::forwardStages(ConstMatrixView image, Activations &acts) const {
+    ConstMatrixView current = image;
+    for (size_t i = 0; i < convs.size(); i++) {
+        const Conv2D &conv = convs[i];
+        int positions = conv.getOutHeight() * conv.getOutWidth();
+        acts.conv_out.emplace_back(conv.getOutChannels(), positions);
+        conv.forward(current, acts.conv_out[i].view());
+
+        if (pooled[i]) {
+            acts.pool_out.emplace_back(conv.getOutChannels(),
+                                       pools[i].getOutHeight() * pools[i].getOutWidth());
+            pools[i].forward(acts.conv_out[i].view(), acts.pool_out[i].view());
+        } else {
+            acts.pool_out.emplace_back(0, 0); // Keep the indexes lined up
+        }
+        current = stageOutput(acts, (int)i);
+    }
+}
+
+ConstMatrixView ConvNet::stageOutput(const Activations &acts, int stage) const {
+    return pooled[stage] ? acts.pool_out[stage].view() : acts.conv_out[stage].view();
+}
+
+std::vector<double> ConvNet::feedForward(const std::vector<double> &image) {
+    if (image.size() != (size_t)channels * height * width) {
+        std::cerr << "Error: Image size does not match the ConvNet input." << std::endl;
+        return std::vector<double>();
+    }
+    Activations acts;
+    forwardStages(ConstMatrixView(image.data(), channels, height * width), acts);
+
+    // Flatten : the C x (H*W) maps are already one contiguous block, read it as a column
+    ConstMatrixView last = convs.empty() ? ConstMatrixView(image.data(), channels, height * width)
+                                         : stageOutput(acts, (int)convs.size() - 1);
+    std::vector<double> result(head.getOutputNodes());
+    head.feedForward(ConstMatrixView(last.data, last.rows * last.cols, 1),
+                     MatrixView::column(result.data(), (int)result.size()));
+    return result;
+}
+
+void ConvNet::train(const std::vector<double> &image, const std::vector<double> &target) {
+    if (image.size() != (size_t)channels * height * width || target.size() != (size_t)head.getOutputNodes()) {
+        std::cerr << "Input or Target size mismatch!" << std::endl;
+        return;
+    }
+
+    // PHASE 1 : FEED FORWARD through every stage (keeping the maps for the way back)
+    ConstMatrixView image_view(image.data(), channels, height * width);
+    Activations acts;
+    forwardStages(image_view, acts);
+    int stages = (int)convs.size();
+    ConstMatrixView last = stages == 0 ? image_view : stageOutput(acts, stages - 1);
+
+    // PHASE 2 : The dense head trains as usual and tells us the error of its inputs
+    Matrix errors(last.rows, last.cols);
+    head.train(ConstMatrixView(last.data, last.rows * last.cols, 1), ConstMatrixView::column(target),
+               MatrixView(errors.view().data, last.rows * last.cols, 1));
+
+    // PHASE 3 : Back down through the stages, last one first
+    for (int i = stages - 1; i >= 0; i--) {
+        if (pooled[i]) {
+            // Pooling : the error goes to the pixel that won each block
+            Matrix pool_errors(acts.conv_out[i].getRows(), acts.conv_out[i].getCols());
+            pools[i].backward(acts.conv_out[i].view(), errors.view(), pool_errors.view());
+            errors = pool_errors;
+        }
+        ConstMatrixView input = i == 0 ? image_view : stageOutput(acts, i - 1);
+        if (i == 0) {
+            // Nobody below the first layer needs its input errors
+            convs[i].backward(input, acts.conv_out[i].view(), errors.view(), MatrixView(nullptr, 0, 0));
+        } else {
+            Matrix input_errors(input.rows, input.cols);
+            convs[i].backward(input, acts.conv_out[i].view(), errors.view(), input_errors.view());
+            errors = input_errors;
+        }
+    }
+}
+
+void ConvNet::setConvLearningRate(double rate) {
+    for (Conv2D &conv : convs) conv.setLearningRate(rate);
+}
+
+long ConvNet::inferenceCost() const {
+    long cost = 0;
+    for (const Conv2D &conv : convs) cost += conv.multiplyAdds();
+    cost += (long)head.getHiddenNodes() * head.getInputNodes();
+    cost += (long)head.getOutputNodes() * head.getHiddenNodes();
+    return cost;
+}
@@ -0,0 +1,164 @@
+#ifndef CONV_LAYERS_H
+#define CONV_LAYERS_H
+
+#include <vector>
+#include "matrix.h"
+#include "neuralNetwork.h"
+
+/*
+    The Problem : The dense network does not know it is looking at a picture.
+    NeuralNetwork sees a 28x28 digit as 784 unrelated numbers. A "1" moved two pixels
+    to the right is a brand new input for it, and every hidden node needs its own
+    784 weights to find the same stroke in every position.
+
+    The Fix : Convolution
+    A small filter (eg. 3x3 weights) is slid over the whole image and gives one
+    output per position ("feature map"). The SAME 9 weights are used everywhere, so
+    a stroke detector learned in one corner works in every corner, for 9 weights
+    instead of 784. Pooling then keeps the strongest answer of every 2x2 block,
+    halving the map so the next layer sees a bigger area for the same cost.
+
+    FEATURE MAPS
+    A stack of C maps of H x W is stored as a C x (H*W) matrix : row c is map c,
+    row-major inside. A MNIST image (784 doubles) is simply a 1 x 784 view of it.
+
+    IM2COL : convolution as ONE matrix multiply
+    Copy every (C x k x k) patch of the input into a column of a big matrix:
+        cols : (C*k*k) x (outH*outW)
+    then all filters at all positions are one product:
+        outputs = weights (filters x C*k*k) * cols
+    This runs on the same tiled / threaded Matrix::multiply as everything else.
+    The copy costs k*k times the input memory, so for the common 3x3 / stride 1
+    case there is also a DIRECT path that slides the filters without building cols.
+*/
+
+// How a Conv2D computes its products
+enum class ConvAlgorithm {
+    Auto,   // Direct for 3x3 stride 1, im2col for everything else
+    Im2col, // Always lower to Matrix::multiply
+    Direct  // Always slide the filters directly
+};
+
+// Convolution Layer (with ReLU activation)
+/*
+    ReLU (max(0, x)) instead of sigmoid : it does not flatten out for big inputs,
+    so the error still gets through after several stacked layers.
+    Layers keep no per-sample state : forward() and backward() are given the
+    maps they need, so one layer can serve many threads during inference.
+*/
+class Conv2D {
+private:
+    // 1. Shape
+    int in_channels, in_height, in_width;
+    int out_channels, kernel, stride, padding;
+    int out_height, out_width;
+    double learning_rate;
+    ConvAlgorithm algorithm;
+
+    // 2. Parameters
+    Matrix weights; // out_channels x (in_channels * kernel * kernel), one filter per row
+    Matrix bias;    // out_channels x 1
+
+    bool useDirect() const;
+    void im2col(ConstMatrixView input, MatrixView cols) const;
+    void col2im(ConstMatrixView cols, MatrixView input_errors) const;
+    void forwardDirect(ConstMatrixView input, MatrixView output) const;
+    void backwardDirect(ConstMatrixView input, ConstMatrixView gradients, MatrixView input_errors,
+                        Matrix &weight_deltas) const;
+
+public:
+    Conv2D(int in_channels, int in_height, int in_width, int out_channels, int kernel,
+           int stride = 1, int padding = 0);
+
+    // Forward pass
+    // input : in_channels x (in_height * in_width), output : out_channels x (outH * outW)
+    // Returns false on a size mismatch.
+    bool forward(ConstMatrixView input, MatrixView output) const;
+
+    // Backward pass + weight update (same convention as NeuralNetwork::train :
+    // errors = how far each output should move, weights += learning_rate * ...)
+    // input / output  : the maps of the forward pass for this sample
+    // output_errors   : error of every output, same shape as output
+    // input_errors    : filled with the error of every input (through the OLD weights),
+    //                   or MatrixView(nullptr, 0, 0) for the first layer (skipped)
+    bool backward(ConstMatrixView input, ConstMatrixView output, ConstMatrixView output_errors,
+                  MatrixView input_errors);
+
+    int getOutChannels() const { return out_channels; }
+    int getOutHeight() const { return out_height; }
+    int getOutWidth() const { return out_width; }
+    long multiplyAdds() const { return (long)out_channels * out_height * out_width * in_channels * kernel * kernel; }
+    void setLearningRate(double rate) { learning_rate = rate; }
+    void setAlgorithm(ConvAlgorithm a) { algorithm = a; }
+};
+
+// Max Pooling Layer
+// Keeps the biggest value of every size x size block (stride = size). No weights.
+class MaxPool2D {
+private:
+    int channels, in_height, in_width;
+    int size;
+    int out_height, out_width;
+
+public:
+    MaxPool2D(int channels, int in_height, int in_width, int size = 2);
+
+    bool forward(ConstMatrixView input, MatrixView output) const;
+
+    // Each output error goes back to the input that won its block (the rest get 0).
+    // The winners are found again from the input, so nothing is remembered between calls.
+    bool backward(ConstMatrixView input, ConstMatrixView output_errors, MatrixView input_errors) const;
+
+    int getOutHeight() const { return out_height; }
+    int getOutWidth() const { return out_width; }
+};
+
+// One convolution stage of a ConvNet : Conv2D (+ ReLU), then optional max pooling
+struct ConvStage {
+    int filters;     // Output channels
+    int kernel = 3;  // kernel x kernel filters
+    int padding = 1; // Zeros around the input (kernel 3 + padding 1 keeps the size)
+    int pool = 2;    // Pooling block size (1 = no pooling)
+};
+
+// Small Convolutional Network
+/*
+    image -> [Conv2D -> MaxPool] x stages -> flatten -> NeuralNetwork (hidden, outputs)
+    The dense NeuralNetwork is reused as the classifier "head" : it trains exactly as
+    before, and hands the error of its inputs back down to the convolution stages.
+*/
+class ConvNet {
+private:
+    int channels, height, width;
+    std::vector<Conv2D> convs;
+    std::vector<MaxPool2D> pools; // pools[i] follows convs[i] (unused when stage pool <= 1)
+    std::vector<bool> pooled;
+    NeuralNetwork head;
+
+    // Maps of every stage for one sample : conv output, then pooled output
+    struct Activations {
+        std::vector<Matrix> conv_out, pool_out;
+    };
+    void forwardStages(ConstMatrixView image, Activations &acts) const;
+    ConstMatrixView stageOutput(const Activations &acts, int stage) const;
+    static int flatSize(int channels, int height, int width, const std::vector<ConvStage> &stages);
+
+public:
+    // channels x height x width images, e.g. (1, 28, 28) for MNIST
+    // output_head : what the dense head's output layer does (see neuralNetwork.h)
+    ConvNet(int channels, int height, int width, const std::vector<ConvStage> &stages,
+            int hidden_nodes, int output_nodes, OutputHead output_head = OutputHead::Sigmoid);
+
+    // Same interface as NeuralNetwork, image = channels * height * width values
+    std::vector<double> feedForward(const std::vector<double> &image);
+    void train(const std::vector<double> &image, const std::vector<double> &target);
+
+    // Learning rate of the convolution stages (the head keeps its own)
+    void setConvLearningRate(double rate);
+    NeuralNetwork &getHead() { return head; }
+
+    // Multiply-adds for one image (to compare inference cost with a dense network)
+    long inferenceCost() const;
+};
+
+#endif // CONV_LAYERS_H
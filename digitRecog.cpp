@@ -2,8 +2,11 @@
 #include <vector>
 #include <algorithm> // For std::max_element
 #include <iomanip>   // For nice output formatting
-#include "NeuralNetwork.h"
-#include "MnistParser.h"
+#include "neuralNetwork.h"
+#include "mnistParser.h"
+#include "augmenter.h"
+#include "gemmTuner.h"
+#include "inferenceModel.h"
 
 // CONSTANTS (File Paths)
 
@@ -67,11 +70,12 @@ int main()
 
     // Load Training Data
     std::vector<std::vector<double>> train_images = MNISTParser::loadImages(TRAIN_IMAGES);
-    std::vector<std::vector<double>> train_labels = MNISTParser::loadLabels(TRAIN_LABELS);
+    // Labels as plain digits : the softmax head takes the index, no one-hot vectors needed
+    std::vector<int> train_labels = MNISTParser::loadLabelIndices(TRAIN_LABELS);
 
     // Load Test Data
     std::vector<std::vector<double>> test_images = MNISTParser::loadImages(TEST_IMAGES);
-    std::vector<std::vector<double>> test_labels = MNISTParser::loadLabels(TEST_LABELS);
+    std::vector<int> test_labels = MNISTParser::loadLabelIndices(TEST_LABELS);
 
     // Safety Check
     if (train_images.empty() || train_labels.empty())
@@ -82,11 +86,15 @@ int main()
 
     //  STEP 2 : INITIALIZE BRAIN
     std::cout << "\nSTEP 2 Initializing Neural Network..." << std::endl;
+    // Matrix multiply settings for this CPU : loaded from the cache file,
+    // measured once (and saved) the first time we run on a new CPU model
+    GemmTuner::loadOrTune("gemm-tuning.cache", GemmTuner::networkShapes(784, 128, 10, {1}));
     // Input : 784 (28x28 pixels)
     // Hidden : 128 (Enough capacity to learn shapes)
-    // Output : 10 (Digits 0-9)
-    NeuralNetwork nn(784, 128, 10);
-    std::cout << "Topology: 784 -> 128 -> 10" << std::endl;
+    // Output : 10 (Digits 0-9), softmax probabilities trained on cross-entropy
+    //          (exactly one digit is right, and a confident wrong guess gets a big correction)
+    NeuralNetwork nn(784, 128, 10, OutputHead::SoftmaxCrossEntropy);
+    std::cout << "Topology: 784 -> 128 -> 10 (softmax)" << std::endl;
 
     //  STEP 3 : TRAINING
     std::cout << "\nSTEP 3 Training ..." << std::endl;
@@ -98,10 +106,11 @@ int main()
 
     for (int e = 0; e < epochs; e++)
     {
+        double loss_sum = 0.0; // Cross-entropy since the last log line
         for (int i = 0; i < dataset_size; i++)
         {
-            // Train on one image
-            nn.train(train_images[i], train_labels[i]);
+            // Train on one image (returns how wrong the guess was)
+            loss_sum += nn.train(train_images[i], train_labels[i]);
 
             // Progress Log (Every 100 images)
             if (i % 100 == 0)
@@ -109,11 +118,52 @@ int main()
                 // Calculate current accuracy on this specific example
                 std::vector<double> out = nn.feedForward(train_images[i]);
                 int guess = getPrediction(out);
-                int actual = getPrediction(train_labels[i]); // Find which index is 1.0
+                int actual = train_labels[i];
 
                 std::cout << "Epoch " << e + 1 << " | Image " << i << " / " << dataset_size
                           << " | Guess: " << guess << " (Target: " << actual << ")"
+                          << " | Loss: " << loss_sum / (i == 0 ? 1 : 100)
                           << " \r" << std::flush; // \r overwrites the line
+                loss_sum = 0.0;
+            }
+        }
+    }
+
+    //  STEP 3b : AUGMENTED TRAINING
+    // Extra passes over randomly shifted / rotated / distorted copies of the training set.
+    // The copies are built by worker threads while we train, from the raw uint8 images,
+    // so nothing extra is stored and the warping hides behind the training math.
+    int augmented_epochs = 1;
+    if (augmented_epochs > 0)
+    {
+        int rows = 0, cols = 0;
+        std::vector<unsigned char> raw_images = MNISTParser::loadImagesRaw(TRAIN_IMAGES, rows, cols);
+
+        AugmentConfig config;
+        config.max_shift = 2.0;
+        config.max_rotation = 10.0;
+        config.max_scale = 0.1;
+        config.elastic_alpha = 1.5;
+        config.elastic_sigma = 4.0;
+        config.noise_stddev = 0.02;
+
+        Augmenter augmenter(raw_images, rows, cols, config, 64, augmented_epochs);
+        AugmentedBatch batch;
+        int batches_done = 0;
+        int per_epoch = augmenter.batchesPerEpoch();
+
+        while (augmenter.next(batch))
+        {
+            for (int b = 0; b < batch.size; b++)
+            {
+                nn.train(batch.images[b], train_labels[batch.indices[b]]);
+            }
+            batches_done++;
+            if (batches_done % 10 == 0)
+            {
+                std::cout << "Augmented Epoch " << batches_done / per_epoch + 1
+                          << " | Batch " << batches_done % per_epoch << " / " << per_epoch
+                          << " \r" << std::flush;
             }
         }
     }
@@ -123,15 +173,19 @@ int main()
     //  STEP 4 : TESTING (ACCURACY)
     std::cout << "\nSTEP 4 Evaluating on Test Set (10,000 images)..." << std::endl;
 
+    // Training is over : freeze the weights into the read-only, pre-packed serving model
+    // (same answers as nn.feedForward, without its per-call allocations and extra passes)
+    InferenceModel model = nn.freeze();
+
     int correct = 0;
     int total_test = test_images.size();
 
     for (int i = 0; i < total_test; i++)
     {
-        std::vector<double> output = nn.feedForward(test_images[i]);
+        std::vector<double> output = model.predict(test_images[i]);
 
         int guess = getPrediction(output);
-        int actual = getPrediction(test_labels[i]);
+        int actual = test_labels[i];
 
         if (guess == actual)
         {
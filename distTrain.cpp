@@ -0,0 +1,166 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm> // For std::max_element
+#include <unistd.h>  // For getpid
+#include "neuralNetwork.h"
+#include "mnistParser.h"
+#include "distributed.h"
+
+// Data-parallel MNIST training on this machine
+/*
+    usage : ./distTrain [workers] [shm|unix|tcp] [base_port]
+    The parent loads MNIST once and forks the workers, so the dataset pages are
+    shared (copy-on-write) instead of loaded once per process.
+    Every worker trains on its own shard and the gradients meet in a ring all-reduce.
+    shm  : POSIX shared memory ring (default)
+    unix : Unix socket ring (same code path as multi-host, but local)
+    tcp  : TCP ring on 127.0.0.1 (swap the addresses for real hosts)
+           rank r listens on base_port + r (default 47000, pick another one to run
+           two jobs side by side or when those ports are taken)
+*/
+
+const std::string TRAIN_IMAGES = "data/train-images-idx3-ubyte/train-images.idx3-ubyte";
+const std::string TRAIN_LABELS = "data/train-labels-idx1-ubyte/train-labels.idx1-ubyte";
+const std::string TEST_IMAGES = "data/t10k-images-idx3-ubyte/t10k-images.idx3-ubyte";
+const std::string TEST_LABELS = "data/t10k-labels-idx1-ubyte/t10k-labels.idx1-ubyte";
+
+// Everything a worker needs (inherited through fork)
+struct RunConfig {
+    std::string transport;
+    std::string shm_name;
+    std::vector<std::string> endpoints;
+    int workers;
+    int epochs;
+    int batch_size;
+    const std::vector<std::vector<double>> *train_images;
+    const std::vector<std::vector<double>> *train_labels;
+    const std::vector<std::vector<double>> *test_images;
+    const std::vector<std::vector<double>> *test_labels;
+};
+
+int getPrediction(const std::vector<double> &output)
+{
+    auto max_iter = std::max_element(output.begin(), output.end());
+    return std::distance(output.begin(), max_iter);
+}
+
+int runWorker(int rank, void *ctx)
+{
+    RunConfig &config = *static_cast<RunConfig *>(ctx);
+
+    // 1. Join the ring
+    Communicator *comm = nullptr;
+    if (config.transport == "shm")
+    {
+        SharedMemoryCommunicator *shm = new SharedMemoryCommunicator(config.shm_name, rank, config.workers);
+        if (!shm->isReady()) { delete shm; return 1; }
+        comm = shm;
+    }
+    else
+    {
+        SocketCommunicator *sock = new SocketCommunicator(config.endpoints, rank);
+        if (!sock->isReady()) { delete sock; return 1; }
+        comm = sock;
+    }
+
+    // 2. Same starting weights everywhere (rank 0's random init wins)
+    std::srand(1234 + rank);
+    NeuralNetwork nn(784, 128, 10);
+    nn.setLearningRate(2.0); // Steps use the batch AVERAGE, so this is larger than plain SGD
+    int code = 0;
+    {
+        DataParallelTrainer trainer(nn, *comm);
+        if (!trainer.syncParameters()) code = 1;
+
+        // 3. Train
+        for (int e = 0; e < config.epochs && code == 0; e++)
+        {
+            if (!trainer.trainEpoch(*config.train_images, *config.train_labels, config.batch_size))
+            {
+                std::cerr << "[RANK " << rank << "] Communication failed." << std::endl;
+                code = 1;
+            }
+            else if (rank == 0)
+            {
+                std::cout << "[RANK 0] Epoch " << e + 1 << " / " << config.epochs << " done" << std::endl;
+            }
+        }
+    }
+
+    // 4. Evaluate (every rank holds identical weights, rank 0 reports)
+    if (code == 0 && rank == 0)
+    {
+        int correct = 0;
+        int total = config.test_images->size();
+        for (int i = 0; i < total; i++)
+        {
+            if (getPrediction(nn.feedForward((*config.test_images)[i])) == getPrediction((*config.test_labels)[i]))
+                correct++;
+        }
+        std::cout << " FINAL ACCURACY: " << (100.0 * correct / std::max(1, total)) << "%" << std::endl;
+    }
+    if (code == 0)
+        comm->barrier();
+    else
+        comm->abort(); // Do not leave the other ranks waiting on the ring
+    delete comm;
+    return code;
+}
+
+int main(int argc, char **argv)
+{
+    RunConfig config;
+    config.workers = argc > 1 ? std::atoi(argv[1]) : 4;
+    config.transport = argc > 2 ? argv[2] : "shm";
+    int base_port = argc > 3 ? std::atoi(argv[3]) : 47000;
+    config.epochs = 3;
+    config.batch_size = 8; // Per worker, global batch = workers * 8
+
+    if (config.workers < 1 || (config.transport != "shm" && config.transport != "unix" && config.transport != "tcp")
+        || base_port < 1 || base_port + config.workers > 65536)
+    {
+        std::cerr << "usage: " << argv[0] << " [workers] [shm|unix|tcp] [base_port]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<double>> train_images = MNISTParser::loadImages(TRAIN_IMAGES);
+    std::vector<std::vector<double>> train_labels = MNISTParser::loadLabels(TRAIN_LABELS);
+    std::vector<std::vector<double>> test_images = MNISTParser::loadImages(TEST_IMAGES);
+    std::vector<std::vector<double>> test_labels = MNISTParser::loadLabels(TEST_LABELS);
+    if (train_images.empty() || train_labels.empty())
+    {
+        std::cerr << " Could not load data. Exiting." << std::endl;
+        return 1;
+    }
+    config.train_images = &train_images;
+    config.train_labels = &train_labels;
+    config.test_images = &test_images;
+    config.test_labels = &test_labels;
+
+    std::string tag = std::to_string(getpid());
+    if (config.transport == "shm")
+    {
+        config.shm_name = "/nn-ring-" + tag;
+        int params = NeuralNetwork(784, 128, 10).parameterCount();
+        if (!SharedMemoryCommunicator::createSegment(config.shm_name, config.workers, params))
+            return 1;
+    }
+    for (int r = 0; r < config.workers; r++)
+    {
+        if (config.transport == "unix")
+            config.endpoints.push_back("unix:/tmp/nn-ring-" + tag + "-" + std::to_string(r) + ".sock");
+        else
+            config.endpoints.push_back("tcp:127.0.0.1:" + std::to_string(base_port + r));
+    }
+
+    std::cout << "[SYSTEM] " << config.workers << " workers over " << config.transport << std::endl;
+    bool ok = launchLocalWorkers(config.workers, runWorker, &config);
+
+    if (config.transport == "shm")
+        SharedMemoryCommunicator::removeSegment(config.shm_name);
+
+    std::cout << (ok ? "SUCCESS :: All workers finished." : "FAILED :: A worker exited with an error.") << std::endl;
+    return ok ? 0 : 1;
+}
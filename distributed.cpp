@@ -0,0 +1,657 @@
+#include "distributed.h"
+#include <atomic>
+#include <cstring>   // For memcpy
+#include <iostream>
+#include <algorithm> // For std::fill, std::min, std::find
+#include <chrono>
+#include <new>       // For placement new
+
+#include <fcntl.h>      // For shm_open flags, fcntl
+#include <sys/mman.h>   // For mmap, shm_open
+#include <sys/stat.h>   // For fstat
+#include <sys/socket.h>
+#include <sys/un.h>     // For Unix socket addresses
+#include <sys/wait.h>   // For waitpid
+#include <netinet/in.h>
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <arpa/inet.h>
+#include <netdb.h>      // For getaddrinfo
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <csignal>    // For kill
+
+// COMMUNICATOR (transport independent ring logic)
+
+Communicator::Communicator(int rank, int world_size)
+    : my_rank(rank), world_size(world_size), timeout_seconds(60.0) {}
+
+// Chunk c of a buffer with `count` numbers split into `parts` pieces
+// The first (count % parts) chunks get one extra number
+static void chunkRange(size_t count, int parts, int c, size_t &begin, size_t &length) {
+    size_t base = count / parts;
+    size_t extra = count % parts;
+    begin = c * base + std::min((size_t)c, extra);
+    length = base + ((size_t)c < extra ? 1 : 0);
+}
+
+// Ring All-Reduce
+/*
+    Step s of Reduce-Scatter : send chunk (r - s), receive chunk (r - s - 1) and ADD it in.
+    After P-1 steps rank r holds the complete sum of chunk (r + 1).
+    Step s of All-Gather : send chunk (r + 1 - s), receive chunk (r - s) and COPY it in.
+*/
+bool Communicator::allReduceSum(double *data, size_t count) {
+    int P = world_size;
+    if (P <= 1 || count == 0) return true;
+
+    size_t max_chunk = (count + P - 1) / P;
+    std::vector<double> incoming(max_chunk);
+
+    for (int s = 0; s < P - 1; s++) {
+        size_t send_begin, send_len, recv_begin, recv_len;
+        chunkRange(count, P, ((my_rank - s) % P + P) % P, send_begin, send_len);
+        chunkRange(count, P, ((my_rank - s - 1) % P + P) % P, recv_begin, recv_len);
+        if (!exchange(data + send_begin, send_len, incoming.data(), recv_len)) return false;
+        for (size_t i = 0; i < recv_len; i++) {
+            data[recv_begin + i] += incoming[i];
+        }
+    }
+
+    for (int s = 0; s < P - 1; s++) {
+        size_t send_begin, send_len, recv_begin, recv_len;
+        chunkRange(count, P, ((my_rank + 1 - s) % P + P) % P, send_begin, send_len);
+        chunkRange(count, P, ((my_rank - s) % P + P) % P, recv_begin, recv_len);
+        if (!exchange(data + send_begin, send_len, data + recv_begin, recv_len)) return false;
+    }
+    return true;
+}
+
+// Broadcast = all-reduce where everybody except the root contributes zeros
+bool Communicator::broadcast(double *data, size_t count, int root) {
+    if (my_rank != root) {
+        std::fill(data, data + count, 0.0);
+    }
+    return allReduceSum(data, count);
+}
+
+// Barrier : P-1 empty exchanges around the ring.
+// Step k cannot finish before the rank k places to the left has started,
+// so after P-1 steps every rank has arrived.
+bool Communicator::barrier() {
+    for (int s = 0; s < world_size - 1; s++) {
+        if (!exchange(nullptr, 0, nullptr, 0)) return false;
+    }
+    return true;
+}
+
+// SHARED MEMORY TRANSPORT
+
+namespace {
+
+    const unsigned int SEGMENT_MAGIC = 0x4E4E5247; // "NNRG"
+
+    // One mailbox per rank. The counters sit on their own cache lines so the
+    // writer and the reader of a mailbox do not fight over the same line.
+    struct alignas(64) SlotHeader {
+        std::atomic<unsigned long long> sent; // Last message written (by the owner)
+        char pad1[64 - sizeof(std::atomic<unsigned long long>)];
+        std::atomic<unsigned long long> ack;  // Last message read (by the right neighbour)
+        char pad2[64 - sizeof(std::atomic<unsigned long long>)];
+    };
+
+    struct alignas(64) SegmentHeader {
+        std::atomic<unsigned int> magic;
+        int world_size;
+        unsigned long long slot_capacity;
+        std::atomic<int> aborted; // Raised by a rank that gave up, read by every spin
+    };
+
+    static_assert(std::atomic<unsigned long long>::is_always_lock_free && std::atomic<int>::is_always_lock_free,
+                  "Shared memory counters must be lock free to work across processes");
+
+    size_t segmentBytes(int world_size, size_t slot_capacity) {
+        return sizeof(SegmentHeader) + world_size * sizeof(SlotHeader)
+             + world_size * slot_capacity * sizeof(double);
+    }
+
+    SlotHeader *slotHeader(void *base, int r) {
+        return reinterpret_cast<SlotHeader *>((char *)base + sizeof(SegmentHeader)) + r;
+    }
+
+    double *slotData(void *base, int world_size, size_t slot_capacity, int r) {
+        char *first = (char *)base + sizeof(SegmentHeader) + world_size * sizeof(SlotHeader);
+        return reinterpret_cast<double *>(first) + r * slot_capacity;
+    }
+
+    // Spin, then back off to yield so oversubscribed machines still make progress
+    // Gives up (returns false) when a rank raised `aborted` or the deadline passed.
+    // The clock is only read every 1024 spins, the flag on every one.
+    template <typename Condition>
+    bool spinUntil(Condition done, const std::atomic<int> &aborted, std::chrono::steady_clock::time_point deadline) {
+        int spins = 0;
+        while (!done()) {
+            if (aborted.load(std::memory_order_relaxed)) return false;
+            if (++spins > 1000) {
+                std::this_thread::yield();
+            }
+            if ((spins & 1023) == 0 && std::chrono::steady_clock::now() > deadline) return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+bool SharedMemoryCommunicator::createSegment(const std::string &name, int world_size, size_t capacity) {
+    size_t slot_capacity = (capacity + world_size - 1) / std::max(1, world_size) + 1;
+    size_t bytes = segmentBytes(world_size, slot_capacity);
+
+    shm_unlink(name.c_str()); // Left over from a crashed run
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Error : Cannot create shared memory segment " << name << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, bytes) != 0) {
+        std::cerr << "Error : Cannot size shared memory segment " << name << std::endl;
+        close(fd);
+        return false;
+    }
+    void *base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error : Cannot map shared memory segment " << name << std::endl;
+        return false;
+    }
+
+    // Fresh pages are zero, construct the atomics in place anyway
+    SegmentHeader *header = new (base) SegmentHeader();
+    header->world_size = world_size;
+    header->slot_capacity = slot_capacity;
+    header->aborted.store(0);
+    for (int r = 0; r < world_size; r++) {
+        SlotHeader *slot = new (slotHeader(base, r)) SlotHeader();
+        slot->sent.store(0);
+        slot->ack.store(0);
+    }
+    header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+    munmap(base, bytes);
+    return true;
+}
+
+void SharedMemoryCommunicator::removeSegment(const std::string &name) {
+    shm_unlink(name.c_str());
+}
+
+SharedMemoryCommunicator::SharedMemoryCommunicator(const std::string &name, int rank, int world_size)
+    : Communicator(rank, world_size), mapping(nullptr), mapping_bytes(0), slot_capacity(0), sequence(0)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Error : Cannot open shared memory segment " << name << std::endl;
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentHeader)) {
+        std::cerr << "Error : Shared memory segment " << name << " is too small" << std::endl;
+        close(fd);
+        return;
+    }
+    void *base = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error : Cannot map shared memory segment " << name << std::endl;
+        return;
+    }
+
+    SegmentHeader *header = reinterpret_cast<SegmentHeader *>(base);
+    if (header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC
+        || header->world_size != world_size
+        || segmentBytes(world_size, header->slot_capacity) > (size_t)info.st_size) {
+        std::cerr << "Error : Shared memory segment " << name << " does not match this ring" << std::endl;
+        munmap(base, info.st_size);
+        return;
+    }
+
+    mapping = base;
+    mapping_bytes = info.st_size;
+    slot_capacity = header->slot_capacity;
+}
+
+SharedMemoryCommunicator::~SharedMemoryCommunicator() {
+    if (mapping) {
+        munmap(mapping, mapping_bytes);
+    }
+}
+
+void SharedMemoryCommunicator::abort() {
+    if (mapping) {
+        reinterpret_cast<SegmentHeader *>(mapping)->aborted.store(1, std::memory_order_relaxed);
+    }
+}
+
+bool SharedMemoryCommunicator::allReduceSum(double *data, size_t count) {
+    // Every ring step moves one chunk, so a chunk has to fit in a mailbox
+    if ((count + world_size - 1) / world_size > slot_capacity) {
+        std::cerr << "Error : All-reduce of " << count << " numbers is bigger than the shared segment." << std::endl;
+        return false;
+    }
+    return Communicator::allReduceSum(data, count);
+}
+
+// Exchange through the mailboxes
+/*
+    1. Wait until the right neighbour has read our previous message (ack)
+    2. Write our chunk into our mailbox, publish it (sent = seq)
+    3. Wait for the left neighbour's message with the same seq, copy it out, ack it
+    Everybody writes before they wait to read, so the ring cannot deadlock.
+    A dead neighbour can still stall it : both waits give up on abort or timeout.
+*/
+bool SharedMemoryCommunicator::exchange(const double *send, size_t send_count, double *recv, size_t recv_count) {
+    if (!mapping || send_count > slot_capacity || recv_count > slot_capacity) return false;
+
+    unsigned long long seq = ++sequence;
+    int prev = (my_rank - 1 + world_size) % world_size;
+    SlotHeader *mine = slotHeader(mapping, my_rank);
+    SlotHeader *theirs = slotHeader(mapping, prev);
+
+    const std::atomic<int> &aborted = reinterpret_cast<SegmentHeader *>(mapping)->aborted;
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(timeout_seconds));
+    auto giveUp = [&] {
+        if (!aborted.load(std::memory_order_relaxed)) {
+            std::cerr << "Error : Rank " << my_rank << " timed out waiting for its ring neighbours." << std::endl;
+            abort(); // Nobody else should keep waiting either
+        }
+        return false;
+    };
+
+    if (!spinUntil([&] { return mine->ack.load(std::memory_order_acquire) >= seq - 1; }, aborted, deadline)) {
+        return giveUp();
+    }
+    if (send_count > 0) {
+        std::memcpy(slotData(mapping, world_size, slot_capacity, my_rank), send, send_count * sizeof(double));
+    }
+    mine->sent.store(seq, std::memory_order_release);
+
+    if (!spinUntil([&] { return theirs->sent.load(std::memory_order_acquire) >= seq; }, aborted, deadline)) {
+        return giveUp();
+    }
+    if (recv_count > 0) {
+        std::memcpy(recv, slotData(mapping, world_size, slot_capacity, prev), recv_count * sizeof(double));
+    }
+    theirs->ack.store(seq, std::memory_order_release);
+    return true;
+}
+
+// SOCKET TRANSPORT
+
+namespace {
+
+    // Parse "unix:/path" or "tcp:host:port" into a socket address
+    bool parseEndpoint(const std::string &endpoint, sockaddr_storage &addr, socklen_t &len, int &family) {
+        std::memset(&addr, 0, sizeof(addr));
+        if (endpoint.compare(0, 5, "unix:") == 0) {
+            std::string path = endpoint.substr(5);
+            sockaddr_un *un = reinterpret_cast<sockaddr_un *>(&addr);
+            if (path.empty() || path.size() >= sizeof(un->sun_path)) return false;
+            un->sun_family = AF_UNIX;
+            std::memcpy(un->sun_path, path.c_str(), path.size() + 1);
+            len = sizeof(sockaddr_un);
+            family = AF_UNIX;
+            return true;
+        }
+        if (endpoint.compare(0, 4, "tcp:") == 0) {
+            std::string rest = endpoint.substr(4);
+            size_t colon = rest.rfind(':');
+            if (colon == std::string::npos) return false;
+            std::string host = rest.substr(0, colon);
+            std::string port = rest.substr(colon + 1);
+
+            addrinfo hints;
+            std::memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo *found = nullptr;
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &found) != 0 || !found) return false;
+            std::memcpy(&addr, found->ai_addr, found->ai_addrlen);
+            len = found->ai_addrlen;
+            family = AF_INET;
+            freeaddrinfo(found);
+            return true;
+        }
+        return false;
+    }
+
+    // Blocking helpers for the short setup handshake
+    bool sendAll(int fd, const void *buf, size_t bytes) {
+        const char *p = (const char *)buf;
+        while (bytes > 0) {
+            ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            bytes -= n;
+        }
+        return true;
+    }
+
+    bool recvAll(int fd, void *buf, size_t bytes) {
+        char *p = (char *)buf;
+        while (bytes > 0) {
+            ssize_t n = ::recv(fd, p, bytes, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            bytes -= n;
+        }
+        return true;
+    }
+
+} // namespace
+
+SocketCommunicator::SocketCommunicator(const std::vector<std::string> &endpoints, int rank)
+    : Communicator(rank, (int)endpoints.size()), next_fd(-1), prev_fd(-1)
+{
+    if (world_size <= 1) return;
+
+    // 1. Listen on our own endpoint
+    sockaddr_storage addr;
+    socklen_t addr_len;
+    int family;
+    if (!parseEndpoint(endpoints[rank], addr, addr_len, family)) {
+        std::cerr << "Error : Bad endpoint " << endpoints[rank] << std::endl;
+        return;
+    }
+    int listen_fd = socket(family, SOCK_STREAM, 0);
+    if (family == AF_UNIX) {
+        unix_path = endpoints[rank].substr(5);
+        unlink(unix_path.c_str()); // Stale socket file from an earlier run
+    } else {
+        int yes = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    }
+    if (listen_fd < 0 || bind(listen_fd, (sockaddr *)&addr, addr_len) != 0 || listen(listen_fd, 4) != 0) {
+        std::cerr << "Error : Cannot listen on " << endpoints[rank] << std::endl;
+        if (listen_fd >= 0) close(listen_fd);
+        return;
+    }
+
+    // 2. Connect to the right neighbour (it may not be listening yet, so retry)
+    int next = (rank + 1) % world_size;
+    if (!parseEndpoint(endpoints[next], addr, addr_len, family)) {
+        std::cerr << "Error : Bad endpoint " << endpoints[next] << std::endl;
+        close(listen_fd);
+        return;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (next_fd < 0 && std::chrono::steady_clock::now() < deadline) {
+        int fd = socket(family, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (sockaddr *)&addr, addr_len) == 0) {
+            next_fd = fd;
+        } else {
+            if (fd >= 0) close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    if (next_fd < 0) {
+        std::cerr << "Error : Rank " << rank << " cannot reach " << endpoints[next] << std::endl;
+        close(listen_fd);
+        return;
+    }
+    if (family != AF_UNIX) {
+        int yes = 1;
+        setsockopt(next_fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); // Small chunks go out right away
+    }
+
+    // 3. Say who we are, accept the left neighbour and check who it is
+    int me = rank;
+    sendAll(next_fd, &me, sizeof(me));
+    prev_fd = accept(listen_fd, nullptr, nullptr);
+    close(listen_fd);
+    int them = -1;
+    int prev = (rank - 1 + world_size) % world_size;
+    if (prev_fd < 0 || !recvAll(prev_fd, &them, sizeof(them)) || them != prev) {
+        std::cerr << "Error : Rank " << rank << " got an unexpected ring neighbour" << std::endl;
+        if (prev_fd >= 0) close(prev_fd);
+        prev_fd = -1;
+        return;
+    }
+
+    // From here on we poll, never block inside send / recv
+    fcntl(next_fd, F_SETFL, fcntl(next_fd, F_GETFL) | O_NONBLOCK);
+    fcntl(prev_fd, F_SETFL, fcntl(prev_fd, F_GETFL) | O_NONBLOCK);
+}
+
+void SocketCommunicator::abort() {
+    if (next_fd >= 0) shutdown(next_fd, SHUT_RDWR);
+    if (prev_fd >= 0) shutdown(prev_fd, SHUT_RDWR);
+}
+
+SocketCommunicator::~SocketCommunicator() {
+    if (next_fd >= 0) close(next_fd);
+    if (prev_fd >= 0) close(prev_fd);
+    if (!unix_path.empty()) unlink(unix_path.c_str());
+}
+
+// Exchange over sockets
+// Push and pull at the same time with poll(), whichever side is ready makes progress.
+// An empty exchange still sends one byte so it can act as a barrier step.
+bool SocketCommunicator::exchange(const double *send, size_t send_count, double *recv, size_t recv_count) {
+    if (!isReady()) return world_size <= 1;
+
+    char token = 0;
+    const char *out = send_count ? (const char *)send : &token;
+    size_t out_left = send_count ? send_count * sizeof(double) : 1;
+    char *in = recv_count ? (char *)recv : &token;
+    size_t in_left = recv_count ? recv_count * sizeof(double) : 1;
+
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(timeout_seconds));
+    while (out_left > 0 || in_left > 0) {
+        pollfd fds[2];
+        int n = 0;
+        if (out_left > 0) fds[n++] = {next_fd, POLLOUT, 0};
+        if (in_left > 0) fds[n++] = {prev_fd, POLLIN, 0};
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        int ready = left.count() > 0 ? poll(fds, n, (int)std::min<long long>(left.count(), 1 << 30)) : 0;
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (ready == 0) {
+            std::cerr << "Error : Rank " << my_rank << " timed out waiting for its ring neighbours." << std::endl;
+            abort();
+            return false;
+        }
+        for (int i = 0; i < n; i++) {
+            if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                if (!(fds[i].revents & POLLIN)) return false; // Peer went away
+            }
+            if (fds[i].fd == next_fd && (fds[i].revents & POLLOUT)) {
+                ssize_t sent = ::send(next_fd, out, out_left, MSG_NOSIGNAL);
+                if (sent < 0 && errno != EAGAIN && errno != EINTR) return false;
+                if (sent > 0) { out += sent; out_left -= sent; }
+            }
+            if (fds[i].fd == prev_fd && (fds[i].revents & POLLIN)) {
+                ssize_t got = ::recv(prev_fd, in, in_left, 0);
+                if (got == 0) return false; // Peer closed
+                if (got < 0 && errno != EAGAIN && errno != EINTR) return false;
+                if (got > 0) { in += got; in_left -= got; }
+            }
+        }
+    }
+    return true;
+}
+
+// BACKGROUND ALL-REDUCE
+
+AsyncAllReduce::AsyncAllReduce(Communicator &comm)
+    : comm(comm), submitted(0), completed(0), failed(false), stopping(false),
+      worker(&AsyncAllReduce::loop, this) {}
+
+AsyncAllReduce::~AsyncAllReduce() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+void AsyncAllReduce::submit(double *data, size_t count) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        jobs.push_back({data, count});
+        submitted++;
+    }
+    cv.notify_all();
+}
+
+bool AsyncAllReduce::waitAll() {
+    std::unique_lock<std::mutex> guard(lock);
+    cv.wait(guard, [this] { return completed == submitted; });
+    bool ok = !failed;
+    failed = false;
+    return ok;
+}
+
+void AsyncAllReduce::loop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            cv.wait(guard, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return; // Stopping and nothing left
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        bool ok = comm.allReduceSum(job.data, job.count);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            completed++;
+            if (!ok) failed = true;
+        }
+        cv.notify_all();
+    }
+}
+
+// DATA-PARALLEL TRAINER
+
+DataParallelTrainer::DataParallelTrainer(NeuralNetwork &nn, Communicator &comm)
+    : nn(nn), comm(comm),
+      grads(nn.getInputNodes(), nn.getHiddenNodes(), nn.getOutputNodes()),
+      reducer(comm) {}
+
+bool DataParallelTrainer::syncParameters() {
+    std::vector<double> params(nn.parameterCount());
+    nn.copyParametersTo(params.data());
+    if (!comm.broadcast(params.data(), params.size(), 0)) return false;
+    nn.setParametersFrom(params.data());
+    return true;
+}
+
+// Called by computeGradients as soon as the output layer block is final
+void DataParallelTrainer::sendOutputLayer(void *self) {
+    DataParallelTrainer *trainer = static_cast<DataParallelTrainer *>(self);
+    trainer->reducer.submit(trainer->grads.buffer.data(), trainer->grads.output_layer_size);
+}
+
+bool DataParallelTrainer::trainEpoch(const std::vector<std::vector<double>> &inputs,
+                                     const std::vector<std::vector<double>> &targets, int batch_size) {
+    int P = comm.size();
+    int r = comm.rank();
+    if (batch_size <= 0 || inputs.size() != targets.size()) {
+        std::cerr << "Error : Bad batch size or inputs / targets size mismatch." << std::endl;
+        return false;
+    }
+
+    // Same step count on every rank, or the ring would wait forever
+    int steps = ((int)inputs.size() / P) / batch_size;
+    double scale = 1.0 / ((double)batch_size * P); // Average over the global batch
+
+    Matrix x(nn.getInputNodes(), batch_size);
+    Matrix t(nn.getOutputNodes(), batch_size);
+    for (int step = 0; step < steps; step++) {
+        // Pack this rank's samples of the step, one per column
+        for (int b = 0; b < batch_size; b++) {
+            int index = (step * batch_size + b) * P + r; // Shard : every P-th sample
+            if (inputs[index].size() != (size_t)x.getRows() || targets[index].size() != (size_t)t.getRows()) {
+                std::cerr << "Error : Sample " << index << " does not match the network." << std::endl;
+                return false;
+            }
+            for (int i = 0; i < x.getRows(); i++) x.at(i, b) = inputs[index][i];
+            for (int i = 0; i < t.getRows(); i++) t.at(i, b) = targets[index][i];
+        }
+
+        // Output block is submitted from inside, before the hidden layer backward starts
+        grads.clear();
+        nn.computeGradients(x.view(), t.view(), grads, sendOutputLayer, this);
+
+        // Hidden layer block goes out after the output block (same order on every rank)
+        reducer.submit(grads.buffer.data() + grads.output_layer_size,
+                       grads.buffer.size() - grads.output_layer_size);
+        if (!reducer.waitAll()) return false;
+
+        nn.applyGradients(grads, scale);
+    }
+    return true;
+}
+
+// LOCAL LAUNCHER
+
+bool launchLocalWorkers(int count, int (*worker)(int rank, void *ctx), void *ctx) {
+    std::cout.flush(); // Do not duplicate buffered output into the children
+    std::vector<pid_t> children;
+    bool ok = true;
+    for (int r = 0; r < count; r++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "Error : fork failed for rank " << r << std::endl;
+            ok = false;
+            break;
+        }
+        if (pid == 0) {
+            int code = worker(r, ctx);
+            std::cout.flush();
+            _exit(code);
+        }
+        children.push_back(pid);
+    }
+
+    // Reap in whatever order they finish. The first failure (or a missing rank)
+    // means the rest may be stuck on the ring, so they are killed.
+    bool killed = false;
+    auto killAll = [&] {
+        if (killed) return;
+        killed = true;
+        for (pid_t pid : children) {
+            if (pid > 0) kill(pid, SIGTERM);
+        }
+    };
+    if (!ok) killAll();
+
+    size_t running = children.size();
+    while (running > 0) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break; // No children left
+        }
+        auto it = std::find(children.begin(), children.end(), pid);
+        if (it == children.end()) continue; // Not one of ours
+        *it = -1; // Reaped : never signal this pid again
+        running--;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            if (!killed) {
+                std::cerr << "Error : Rank " << (it - children.begin()) << " failed, stopping the others." << std::endl;
+            }
+            ok = false;
+            killAll();
+        }
+    }
+    return ok;
+}
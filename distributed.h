@@ -0,0 +1,202 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "neuralNetwork.h"
+
+/*
+    The Problem : One process, one address space.
+    To train with more than one process, every process trains its OWN copy of
+    the network on its OWN slice (shard) of the dataset. After every mini-batch they
+    add up their gradients so all copies take exactly the same step and stay identical.
+    That "everybody sums, everybody gets the sum" operation is called ALL-REDUCE.
+
+    RING ALL-REDUCE
+    The processes (ranks) sit in a circle, each only talks to its right neighbour.
+    The gradient buffer is cut into P chunks (P = number of ranks).
+    1. Reduce-Scatter (P-1 steps) : pass a chunk right, the neighbour adds its own
+       copy of that chunk and passes it on. Afterwards every rank owns one fully summed chunk.
+    2. All-Gather (P-1 steps) : pass the finished chunks around the circle so everybody
+       ends up with every summed chunk.
+    Every rank sends 2 * (P-1) / P of the buffer in total, no matter how many ranks
+    there are, and no rank is a bottleneck.
+
+    TRANSPORTS
+    The ring only needs "send to right neighbour, receive from left neighbour":
+    - SharedMemoryCommunicator : same machine, POSIX shared memory mailboxes
+    - SocketCommunicator       : TCP (other hosts) or Unix sockets (same host)
+*/
+
+class Communicator {
+protected:
+    int my_rank;
+    int world_size;
+    double timeout_seconds; // Longest wait for a neighbour before giving up
+
+    // Send `send_count` numbers to the right neighbour and receive
+    // `recv_count` numbers from the left neighbour (both at the same time)
+    virtual bool exchange(const double *send, size_t send_count, double *recv, size_t recv_count) = 0;
+
+public:
+    Communicator(int rank, int world_size);
+    virtual ~Communicator() {}
+
+    int rank() const { return my_rank; }
+    int size() const { return world_size; }
+
+    // data = sum of `data` over all ranks (in place, every rank gets the result)
+    virtual bool allReduceSum(double *data, size_t count);
+
+    // Every rank gets the root's `data`
+    bool broadcast(double *data, size_t count, int root);
+
+    // Nobody leaves until everybody arrived
+    bool barrier();
+
+    // DEAD PEERS
+    // A rank that crashes or gives up never sends again, so its neighbours would wait
+    // forever. Every wait ends after the timeout (the call then returns false), and a
+    // rank that fails calls abort() so the others stop right away instead.
+    void setTimeout(double seconds) { timeout_seconds = seconds; }
+    virtual void abort() {}
+};
+
+// Shared Memory Transport
+/*
+    One shared segment holds a mailbox per rank. A rank writes the chunk into its
+    own mailbox and bumps a "sent" counter; the right neighbour waits for the counter,
+    copies the chunk out and bumps an "ack" counter so the mailbox can be reused.
+    Counters are atomics inside the shared pages, no locks or system calls per step.
+    The segment also holds an "aborted" flag : any rank can raise it, and every
+    waiting rank sees it on its next spin and fails its all-reduce.
+
+    The segment is created once (createSegment) before the workers start,
+    then every worker attaches with its rank.
+*/
+class SharedMemoryCommunicator : public Communicator {
+private:
+    void *mapping;
+    size_t mapping_bytes;
+    size_t slot_capacity; // Numbers per mailbox
+    unsigned long long sequence;
+
+    bool exchange(const double *send, size_t send_count, double *recv, size_t recv_count) override;
+
+public:
+    // capacity = biggest allReduceSum count that will be used
+    static bool createSegment(const std::string &name, int world_size, size_t capacity);
+    static void removeSegment(const std::string &name);
+
+    SharedMemoryCommunicator(const std::string &name, int rank, int world_size);
+    ~SharedMemoryCommunicator();
+
+    bool isReady() const { return mapping != nullptr; }
+    bool allReduceSum(double *data, size_t count) override;
+    void abort() override;
+};
+
+// Socket Transport
+/*
+    endpoints[r] is where rank r listens:
+        "unix:/tmp/ring-0.sock"  (same host)
+        "tcp:127.0.0.1:47000"    (any host)
+    Every rank listens on its own endpoint, connects to the next rank's endpoint
+    and accepts one connection from the previous rank.
+    Sends and receives are interleaved with poll() so big chunks cannot deadlock
+    the ring when every rank sends at once.
+*/
+class SocketCommunicator : public Communicator {
+private:
+    int next_fd; // Connection to the right neighbour (we send)
+    int prev_fd; // Connection from the left neighbour (we receive)
+    std::string unix_path; // Cleaned up on destruction
+
+    bool exchange(const double *send, size_t send_count, double *recv, size_t recv_count) override;
+
+public:
+    SocketCommunicator(const std::vector<std::string> &endpoints, int rank);
+    ~SocketCommunicator();
+
+    bool isReady() const { return next_fd >= 0 && prev_fd >= 0; }
+    void abort() override; // Shut both connections : the neighbours see the ring break
+};
+
+// Background All-Reduce
+/*
+    Runs all-reduces on a helper thread so the caller can keep computing.
+    Jobs run strictly in submit order, so as long as every rank submits the
+    same blocks in the same order the ring stays in step.
+*/
+class AsyncAllReduce {
+private:
+    struct Job {
+        double *data;
+        size_t count;
+    };
+
+    Communicator &comm;
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<Job> jobs;
+    int submitted;
+    int completed;
+    bool failed;
+    bool stopping;
+    std::thread worker;
+
+    void loop();
+
+public:
+    explicit AsyncAllReduce(Communicator &comm);
+    ~AsyncAllReduce();
+
+    void submit(double *data, size_t count);
+    bool waitAll(); // false if any all-reduce failed
+};
+
+// Data-Parallel Trainer
+/*
+    Rank r trains on samples r, r + P, r + 2P, ... (its shard).
+    Per step every rank backpropagates its local mini-batch as ONE batch (the columns
+    of a matrix) into one gradient buffer. The output layer gradients of the whole
+    batch are finished first and their block starts travelling around the ring
+    while the hidden layer backward of the whole batch is computed (overlap of
+    communication and compute). Then the hidden block follows, and every rank
+    applies the same summed step.
+    Only the output block can overlap : the hidden block is the last thing computed,
+    so its all-reduce (the bigger one) still waits for the backward pass to end.
+*/
+class DataParallelTrainer {
+private:
+    NeuralNetwork &nn;
+    Communicator &comm;
+    NetworkGradients grads;
+    AsyncAllReduce reducer;
+
+    static void sendOutputLayer(void *self);
+
+public:
+    DataParallelTrainer(NeuralNetwork &nn, Communicator &comm);
+
+    // Copy rank 0's weights to every rank (call once before training)
+    bool syncParameters();
+
+    // One pass over this rank's shard with `batch_size` samples per rank per step.
+    // Every rank runs the same number of steps. Returns false if communication failed.
+    bool trainEpoch(const std::vector<std::vector<double>> &inputs,
+                    const std::vector<std::vector<double>> &targets, int batch_size);
+};
+
+// Local Launcher
+// Forks `count` worker processes on this machine, runs worker(rank, ctx) in each
+// and waits for all of them. Returns true if every worker returned 0.
+// As soon as one worker fails (or a fork fails) the others are killed : they could
+// be waiting on the ring for the missing rank.
+bool launchLocalWorkers(int count, int (*worker)(int rank, void *ctx), void *ctx);
+
+#endif // DISTRIBUTED_H
@@ -0,0 +1,215 @@
+#include "gemmTuner.h"
+#include "threadPool.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <chrono>
+#include <algorithm> // For std::max
+#include <cstdio>    // For std::rename
+
+namespace GemmTuner {
+
+    std::string cpuModel() {
+        std::ifstream info("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(info, line)) {
+            // Line looks like "model name	: Intel(R) Xeon(R) ..."
+            if (line.compare(0, 10, "model name") == 0) {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) {
+                    size_t start = line.find_first_not_of(" \t", colon + 1);
+                    if (start != std::string::npos) return line.substr(start);
+                }
+            }
+        }
+        return "unknown";
+    }
+
+    std::vector<Shape> networkShapes(int input_nodes, int hidden_nodes, int output_nodes,
+                                     const std::vector<int> &batch_sizes) {
+        std::vector<Shape> shapes;
+        for (int b : batch_sizes) {
+            shapes.push_back({hidden_nodes, b, input_nodes, false, false});  // weights_ih * inputs
+            shapes.push_back({output_nodes, b, hidden_nodes, false, false}); // weights_ho * hidden
+            shapes.push_back({hidden_nodes, b, output_nodes, true, false});  // weights_ho.transposed() * output_errors
+            shapes.push_back({output_nodes, hidden_nodes, b, false, true});  // gradients * hidden.transposed()
+            shapes.push_back({hidden_nodes, input_nodes, b, false, true});   // hidden_gradients * inputs.transposed()
+        }
+        return shapes;
+    }
+
+    // Helper : average seconds per multiply with this setting
+    // Repeats until at least ~20ms have passed so tiny shapes are measured fairly
+    static double timeConfig(ConstMatrixView a, ConstMatrixView b, Matrix &out, const GemmConfig &config) {
+        using Clock = std::chrono::steady_clock;
+        Matrix::multiply(a, b, out.view(), config); // Warm up caches
+        int reps = 0;
+        Clock::time_point start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            Matrix::multiply(a, b, out.view(), config);
+            reps++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < 0.02);
+        return elapsed / reps;
+    }
+
+    GemmConfig tune(const Shape &shape, int max_threads) {
+        // A transposed operand is stored the other way round and read through
+        // .transposed(), exactly like weights_ho / hidden / inputs in NeuralNetwork
+        Matrix a_store(shape.a_transposed ? shape.k : shape.m, shape.a_transposed ? shape.m : shape.k);
+        Matrix b_store(shape.b_transposed ? shape.n : shape.k, shape.b_transposed ? shape.k : shape.n);
+        Matrix out(shape.m, shape.n);
+        a_store.randomize();
+        b_store.randomize();
+        ConstMatrixView a = ConstMatrixView(a_store.view());
+        ConstMatrixView b = ConstMatrixView(b_store.view());
+        if (shape.a_transposed) a = a.transposed();
+        if (shape.b_transposed) b = b.transposed();
+
+        // 1. Tile sizes and loop order on one thread
+        // Tiles bigger than the matrix behave like the whole matrix, so skip repeats
+        const int tile_rows[] = {8, 32, 128};
+        const int tile_cols[] = {32, 128, 512};
+        const int tile_depth[] = {64, 256, 1024};
+        GemmConfig best;
+        double best_time = 1e30;
+        for (int order = 0; order < 2; order++) {
+            for (int tm : tile_rows) {
+                if (tm > shape.m && tm != tile_rows[0]) continue;
+                for (int tn : tile_cols) {
+                    if (tn > shape.n && tn != tile_cols[0]) continue;
+                    for (int tk : tile_depth) {
+                        if (tk > shape.k && tk != tile_depth[0]) continue;
+                        GemmConfig candidate;
+                        candidate.tile_m = tm;
+                        candidate.tile_n = tn;
+                        candidate.tile_k = tk;
+                        candidate.loop_order = order;
+                        candidate.threads = 1;
+                        double t = timeConfig(a, b, out, candidate);
+                        if (t < best_time) {
+                            best_time = t;
+                            best = candidate;
+                        }
+                    }
+                }
+            }
+        }
+
+        // 2. Thread count for the winning tiles (only more threads if it really pays)
+        // threads > 1 skips multiply()'s grain check, so what is measured here is
+        // exactly what runs later (and the global grain is never touched)
+        if (max_threads <= 0) {
+            max_threads = ThreadPool::global().size();
+        }
+        long tiles = (long)((shape.m + best.tile_m - 1) / best.tile_m) * ((shape.n + best.tile_n - 1) / best.tile_n);
+        GemmConfig single = best;
+        for (int threads = 2; threads <= max_threads; threads *= 2) {
+            if (tiles < threads) break; // Not enough result tiles to share out
+            GemmConfig candidate = single;
+            candidate.threads = threads;
+            double t = timeConfig(a, b, out, candidate);
+            if (t < best_time * 0.9) { // 10% margin against timing noise
+                best_time = t;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    // Cache File
+    // Reads section by section : "cpu ..." starts a section, number lines belong to it
+    std::vector<Result> loadCache(const std::string &path, const std::string &cpu) {
+        std::vector<Result> results;
+        std::ifstream file(path);
+        if (!file.is_open()) return results; // No cache yet, not an error
+
+        std::string line;
+        bool ours = false;
+        while (std::getline(file, line)) {
+            if (line.compare(0, 4, "cpu ") == 0) {
+                ours = line.substr(4) == cpu;
+                continue;
+            }
+            if (!ours || line.empty() || line[0] == '#') continue;
+
+            std::istringstream in(line);
+            Result r;
+            // Old lines without the layout columns fail here and get tuned again
+            if (in >> r.shape.m >> r.shape.n >> r.shape.k >> r.shape.a_transposed >> r.shape.b_transposed
+                   >> r.config.tile_m >> r.config.tile_n >> r.config.tile_k >> r.config.loop_order
+                   >> r.config.threads && (in >> std::ws).eof()) {
+                results.push_back(r);
+            } else {
+                std::cerr << "[TUNER] Skipping bad cache line: " << line << std::endl;
+            }
+        }
+        return results;
+    }
+
+    bool saveCache(const std::string &path, const std::string &cpu, const std::vector<Result> &results) {
+        // Keep every other CPU's section as it is
+        std::vector<std::string> others;
+        {
+            std::ifstream file(path);
+            std::string line;
+            bool ours = false;
+            while (std::getline(file, line)) {
+                if (line.compare(0, 4, "cpu ") == 0) ours = line.substr(4) == cpu;
+                if (!ours && !line.empty() && line[0] != '#') others.push_back(line);
+            }
+        }
+
+        // Write to a temporary file and rename, so a crash never leaves half a cache
+        std::string temp = path + ".tmp";
+        std::ofstream out(temp);
+        if (!out.is_open()) {
+            std::cerr << "[TUNER] Cannot write cache file: " << path << std::endl;
+            return false;
+        }
+        out << "# GEMM tuning cache : m n k a_transposed b_transposed tile_m tile_n tile_k loop_order threads\n";
+        for (const std::string &line : others) out << line << "\n";
+        out << "cpu " << cpu << "\n";
+        for (const Result &r : results) {
+            out << r.shape.m << " " << r.shape.n << " " << r.shape.k << " "
+                << r.shape.a_transposed << " " << r.shape.b_transposed << " "
+                << r.config.tile_m << " " << r.config.tile_n << " " << r.config.tile_k << " "
+                << r.config.loop_order << " " << r.config.threads << "\n";
+        }
+        out.close();
+        return out.good() && std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+
+    void loadOrTune(const std::string &path, const std::vector<Shape> &shapes) {
+        std::string cpu = cpuModel();
+        std::vector<Result> results = loadCache(path, cpu);
+
+        bool changed = false;
+        for (const Shape &shape : shapes) {
+            bool known = false;
+            for (const Result &r : results) {
+                if (r.shape.m == shape.m && r.shape.n == shape.n && r.shape.k == shape.k
+                    && r.shape.a_transposed == shape.a_transposed && r.shape.b_transposed == shape.b_transposed) {
+                    known = true;
+                }
+            }
+            if (!known) {
+                std::cout << "[TUNER] Tuning " << shape.m << "x" << shape.k << " * "
+                          << shape.k << "x" << shape.n
+                          << (shape.a_transposed ? " (A transposed)" : "") << (shape.b_transposed ? " (B transposed)" : "")
+                          << " for " << cpu << std::endl;
+                results.push_back({shape, tune(shape)});
+                changed = true;
+            }
+        }
+
+        for (const Result &r : results) {
+            Matrix::setGemmConfig(r.shape.m, r.shape.n, r.shape.k, r.config);
+        }
+        if (changed) {
+            saveCache(path, cpu, results);
+        }
+    }
+
+} // namespace GemmTuner
@@ -0,0 +1,68 @@
+#ifndef GEMM_TUNER_H
+#define GEMM_TUNER_H
+
+#include <vector>
+#include <string>
+#include "matrix.h"
+
+/*
+    The Problem : The best tile sizes depend on the machine.
+    A tile that fits the cache of one CPU spills out of the cache of another,
+    and whether two threads beat one depends on the core count and the shape.
+    Hard-coding one setting means every other machine runs someone else's tuning.
+
+    The Fix : Measure, then remember.
+    1. For every shape the network actually multiplies, time a grid of candidate
+       settings (tile sizes x loop order), then the best thread count for the winner
+       The operands have the same layout as in training (dense, or a transposed view)
+    2. Save the winners in a small text file, keyed by the CPU model name
+    3. On the next start, load the saved winners for THIS CPU and skip the benchmark
+
+    One cache file can hold results for several CPU models, so the same file
+    can be shared by machines of different generations.
+
+    Cache file format (plain text):
+        cpu <model name>
+        <m> <n> <k> <a_transposed> <b_transposed> <tile_m> <tile_n> <tile_k> <loop_order> <threads>
+        ...
+*/
+
+namespace GemmTuner {
+
+    struct Shape {
+        int m, n, k; // (m x k) * (k x n)
+        // How the operands reach multiply() : a transposed view walks its matrix with
+        // swapped strides, and the best tiles / loop order for that access pattern are
+        // not the ones for a dense operand, so the benchmark uses the same layout
+        bool a_transposed = false;
+        bool b_transposed = false;
+    };
+
+    struct Result {
+        Shape shape;
+        GemmConfig config;
+    };
+
+    // CPU model from /proc/cpuinfo ("unknown" if not available)
+    std::string cpuModel();
+
+    // Every product NeuralNetwork does for one training / inference step,
+    // for each batch size (number of samples per column block)
+    std::vector<Shape> networkShapes(int input_nodes, int hidden_nodes, int output_nodes,
+                                     const std::vector<int> &batch_sizes);
+
+    // Benchmark candidates for one shape and return the fastest setting
+    GemmConfig tune(const Shape &shape, int max_threads = 0);
+
+    // Read / write the winners for one CPU model (other CPUs in the file are kept)
+    std::vector<Result> loadCache(const std::string &path, const std::string &cpu);
+    bool saveCache(const std::string &path, const std::string &cpu, const std::vector<Result> &results);
+
+    // Startup helper :
+    // load this CPU's saved settings, tune the shapes that are missing, save,
+    // and hand everything to Matrix so multiply() uses it.
+    void loadOrTune(const std::string &path, const std::vector<Shape> &shapes);
+
+} // namespace GemmTuner
+
+#endif // GEMM_TUNER_H
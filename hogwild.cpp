@@ -0,0 +1,151 @@
+#include "hogwild.h"
+#include "softmax.h"
+#include <thread>
+#include <chrono>
+#include <algorithm> // For std::max
+#include <iostream>
+
+// Shared weight access (see "RELAXED ATOMICS" in hogwild.h)
+static inline double loadShared(double &w) {
+    return std::atomic_ref<double>(w).load(std::memory_order_relaxed);
+}
+
+// Racy on purpose : a nudge from another thread landing in between may be lost
+static inline void addShared(double &w, double nudge) {
+    std::atomic_ref<double> ref(w);
+    ref.store(ref.load(std::memory_order_relaxed) + nudge, std::memory_order_relaxed);
+}
+
+HogwildTrainer::HogwildTrainer(NeuralNetwork &nn) : nn(nn), version(0) {}
+
+// One sample, same steps (and same rounding) as NeuralNetwork::train,
+// but every weight is read and written in place in the shared network.
+// Returns the staleness of this update.
+long HogwildTrainer::trainSample(const double *input, const double *target, Scratch &s) {
+    int inputs = nn.input_nodes, hidden = nn.hidden_nodes, outputs = nn.output_nodes;
+    double lr = nn.learning_rate;
+    double *w_ih = nn.weights_ih.view().data; // hidden x inputs
+    double *b_h = nn.bias_h.view().data;
+    double *w_ho = nn.weights_ho.view().data; // outputs x hidden
+    double *b_o = nn.bias_o.view().data;
+
+    bool softmax = nn.output_head == OutputHead::SoftmaxCrossEntropy;
+
+    long seen = version.load(std::memory_order_relaxed);
+
+    // Zero inputs add nothing forward and get no update backward : skip them.
+    // (Adding w * 0.0 leaves a sum unchanged, so this is still the same math.)
+    s.active.clear();
+    for (int k = 0; k < inputs; k++) {
+        if (input[k] != 0.0) s.active.push_back(k);
+    }
+
+    // PHASE 1 : FEED FORWARD
+    for (int i = 0; i < hidden; i++) {
+        double *row = w_ih + (size_t)i * inputs;
+        double sum = 0.0;
+        for (int k : s.active) sum += loadShared(row[k]) * input[k];
+        s.hidden[i] = NeuralNetwork::sigmoid(sum + loadShared(b_h[i]));
+    }
+    for (int o = 0; o < outputs; o++) {
+        double *row = w_ho + (size_t)o * hidden;
+        double sum = 0.0;
+        for (int i = 0; i < hidden; i++) sum += loadShared(row[i]) * s.hidden[i];
+        s.outputs[o] = sum + loadShared(b_o[o]);
+        if (!softmax) s.outputs[o] = NeuralNetwork::sigmoid(s.outputs[o]);
+    }
+
+    // PHASE 2 : BACKPROPAGATION
+    // output error = target - output, hidden error = weights_ho_T * output error (old weights)
+    // (softmax head : the fused kernel turns the logits into target - softmax in one go)
+    // Kept as the error until the hidden errors are done
+    if (softmax) {
+        Softmax::crossEntropy(s.outputs.data(), target, outputs, s.output_gradients.data());
+    } else {
+        for (int o = 0; o < outputs; o++) {
+            s.output_gradients[o] = target[o] - s.outputs[o];
+        }
+    }
+    for (int i = 0; i < hidden; i++) {
+        double sum = 0.0;
+        for (int o = 0; o < outputs; o++) sum += loadShared(w_ho[(size_t)o * hidden + i]) * s.output_gradients[o];
+        s.hidden_errors[i] = sum;
+    }
+    for (int o = 0; o < outputs; o++) {
+        if (softmax) s.output_gradients[o] = s.output_gradients[o] * lr; // No dsigmoid
+        else s.output_gradients[o] = NeuralNetwork::dsigmoid(s.outputs[o]) * s.output_gradients[o] * lr;
+    }
+    for (int i = 0; i < hidden; i++) {
+        s.hidden_gradients[i] = NeuralNetwork::dsigmoid(s.hidden[i]) * s.hidden_errors[i] * lr;
+    }
+
+    // PHASE 3 : GRADIENT DESCENT, straight into the shared weights
+    long staleness = version.load(std::memory_order_relaxed) - seen;
+    for (int o = 0; o < outputs; o++) {
+        double *row = w_ho + (size_t)o * hidden;
+        for (int i = 0; i < hidden; i++) addShared(row[i], s.output_gradients[o] * s.hidden[i]);
+        addShared(b_o[o], s.output_gradients[o]);
+    }
+    for (int i = 0; i < hidden; i++) {
+        double *row = w_ih + (size_t)i * inputs;
+        for (int k : s.active) addShared(row[k], s.hidden_gradients[i] * input[k]);
+        addShared(b_h[i], s.hidden_gradients[i]);
+    }
+    version.fetch_add(1, std::memory_order_relaxed);
+    return staleness;
+}
+
+std::vector<HogwildStats> HogwildTrainer::trainEpoch(const std::vector<std::vector<double>> &inputs,
+                                                     const std::vector<std::vector<double>> &targets,
+                                                     int threads) {
+    if (inputs.size() != targets.size()) {
+        std::cerr << "Error : Inputs / targets size mismatch." << std::endl;
+        return std::vector<HogwildStats>();
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (inputs[i].size() != (size_t)nn.input_nodes || targets[i].size() != (size_t)nn.output_nodes) {
+            std::cerr << "Input or Target size mismatch!" << std::endl;
+            return std::vector<HogwildStats>();
+        }
+    }
+    if (threads <= 0) {
+        threads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    std::vector<HogwildStats> stats(threads);
+    std::atomic<size_t> next_sample(0);
+
+    auto worker = [&](int id) {
+        Scratch scratch;
+        scratch.hidden.resize(nn.hidden_nodes);
+        scratch.hidden_errors.resize(nn.hidden_nodes);
+        scratch.hidden_gradients.resize(nn.hidden_nodes);
+        scratch.outputs.resize(nn.output_nodes);
+        scratch.output_gradients.resize(nn.output_nodes);
+        scratch.active.reserve(nn.input_nodes);
+
+        // Counted in a local : neighbouring stats[] entries share a cache line, so
+        // bumping stats[id] per sample would bounce that line between the workers
+        HogwildStats mine;
+        auto start = std::chrono::steady_clock::now();
+        size_t index;
+        while ((index = next_sample.fetch_add(1, std::memory_order_relaxed)) < inputs.size()) {
+            long staleness = trainSample(inputs[index].data(), targets[index].data(), scratch);
+            mine.samples++;
+            mine.total_staleness += staleness;
+            mine.max_staleness = std::max(mine.max_staleness, staleness);
+        }
+        mine.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats[id] = mine; // Written once, only by this thread
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(worker, t);
+    }
+    worker(0); // The calling thread is worker 0
+    for (std::thread &t : workers) {
+        t.join();
+    }
+    return stats;
+}
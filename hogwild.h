@@ -0,0 +1,71 @@
+#ifndef HOGWILD_H
+#define HOGWILD_H
+
+#include <vector>
+#include <atomic>
+#include "neuralNetwork.h"
+
+/*
+    The Problem : Waiting for each other
+    Synchronous data-parallel training (distributed.h) stops every worker at every
+    step to add up gradients. With many cores, more and more of the time goes
+    into that waiting instead of into training.
+
+    The Hogwild Trick : Don't synchronize at all.
+    Every thread pulls the next sample, runs the SAME math as NeuralNetwork::train,
+    and writes its nudges straight into the one shared set of weights. No locks,
+    no barriers, no gradient buffers. Two threads may update the same weight at the
+    same moment and one of the two nudges is lost - that is accepted on purpose.
+
+    Why it still converges : MNIST is sparse-ish. Most pixels are 0, and a zero input
+    produces no update to its weights, so each sample only touches the weights of
+    its own ~150 lit pixels (plus the small hidden->output layer). Collisions are
+    rare, and a lost nudge is just a little noise on top of SGD's own noise.
+
+    RELAXED ATOMICS
+    A plain double written by one thread while another reads it is a data race,
+    which C++ does not define. Every shared weight is accessed through
+    std::atomic_ref with memory_order_relaxed instead : no locks, no fences, on x86 /
+    ARM the same plain load / store instructions, but the behaviour is defined.
+    "weight += nudge" is a relaxed load then a relaxed store, NOT an atomic add,
+    so racing updates may overwrite each other exactly as in the Hogwild paper.
+
+    STALENESS
+    A global counter goes up once per applied sample. A worker notes the counter
+    before reading the weights and again before writing its nudges : the difference
+    is how many other updates landed in between (how old its view of the weights was).
+    With 1 thread staleness is always 0 and the result matches NeuralNetwork::train.
+*/
+
+// Per-thread statistics of one Hogwild epoch
+struct HogwildStats {
+    long samples = 0;         // Samples this thread trained on
+    long total_staleness = 0; // Sum of per-sample staleness
+    long max_staleness = 0;   // Worst single sample
+    double seconds = 0.0;     // Time this thread spent training
+
+    double meanStaleness() const { return samples ? (double)total_staleness / samples : 0.0; }
+};
+
+class HogwildTrainer {
+private:
+    NeuralNetwork &nn; // Trained in place (no other thread may use it meanwhile)
+    std::atomic<long> version; // Updates applied so far
+
+    // Per-thread scratch, allocated once per worker
+    struct Scratch {
+        std::vector<double> hidden, outputs, output_gradients, hidden_errors, hidden_gradients;
+        std::vector<int> active; // Indexes of non-zero inputs
+    };
+    long trainSample(const double *input, const double *target, Scratch &scratch);
+
+public:
+    explicit HogwildTrainer(NeuralNetwork &nn);
+
+    // One pass over the dataset by `threads` workers sharing the weights.
+    // Samples are handed out in order from a shared counter. Returns one entry per thread.
+    std::vector<HogwildStats> trainEpoch(const std::vector<std::vector<double>> &inputs,
+                                         const std::vector<std::vector<double>> &targets, int threads);
+};
+
+#endif // HOGWILD_H
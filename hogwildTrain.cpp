@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <algorithm> // For std::max_element
+#include <cstdlib>   // For atoi
+#include "neuralNetwork.h"
+#include "mnistParser.h"
+#include "hogwild.h"
+
+// Serial SGD vs lock-free Hogwild SGD on MNIST
+/*
+    usage : ./hogwildTrain [threads] [epochs]
+    All start from the SAME initial weights and see the samples in the same order.
+    After every epoch : test accuracy and samples per second of each, plus the
+    staleness every Hogwild thread saw (how many other updates landed while it
+    was working on a sample).
+
+    Three rows, because two things make Hogwild faster than NeuralNetwork::train :
+      Serial           : NeuralNetwork::train (Matrix temporaries, every input pixel)
+      Hogwild 1 thread : the Hogwild kernel alone (no allocations, zero pixels skipped)
+      Hogwild N threads: the same kernel on N threads
+    Serial -> 1 thread is the kernel, 1 thread -> N threads is the thread scaling.
+*/
+
+const std::string TRAIN_IMAGES = "data/train-images-idx3-ubyte/train-images.idx3-ubyte";
+const std::string TRAIN_LABELS = "data/train-labels-idx1-ubyte/train-labels.idx1-ubyte";
+const std::string TEST_IMAGES = "data/t10k-images-idx3-ubyte/t10k-images.idx3-ubyte";
+const std::string TEST_LABELS = "data/t10k-labels-idx1-ubyte/t10k-labels.idx1-ubyte";
+
+int getPrediction(const std::vector<double> &output)
+{
+    return std::distance(output.begin(), std::max_element(output.begin(), output.end()));
+}
+
+double testAccuracy(NeuralNetwork &nn, const std::vector<std::vector<double>> &images,
+                    const std::vector<std::vector<double>> &labels)
+{
+    int correct = 0;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        if (getPrediction(nn.feedForward(images[i])) == getPrediction(labels[i]))
+            correct++;
+    }
+    return 100.0 * correct / std::max<size_t>(1, images.size());
+}
+
+int main(int argc, char **argv)
+{
+    int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    int epochs = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::vector<std::vector<double>> train_images = MNISTParser::loadImages(TRAIN_IMAGES);
+    std::vector<std::vector<double>> train_labels = MNISTParser::loadLabels(TRAIN_LABELS);
+    std::vector<std::vector<double>> test_images = MNISTParser::loadImages(TEST_IMAGES);
+    std::vector<std::vector<double>> test_labels = MNISTParser::loadLabels(TEST_LABELS);
+    if (train_images.empty() || train_labels.empty() || test_images.empty())
+    {
+        std::cerr << " Could not load data. Exiting." << std::endl;
+        return 1;
+    }
+
+    NeuralNetwork serial(784, 128, 10);
+    NeuralNetwork single = serial; // Same starting weights
+    NeuralNetwork shared = serial;
+    HogwildTrainer hogwild_single(single);
+    HogwildTrainer hogwild(shared);
+    std::cout << "Serial SGD vs Hogwild SGD (" << threads << " threads), 784 -> 128 -> 10" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    using Clock = std::chrono::steady_clock;
+    for (int e = 0; e < epochs; e++)
+    {
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < train_images.size(); i++)
+        {
+            serial.train(train_images[i], train_labels[i]);
+        }
+        double serial_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        hogwild_single.trainEpoch(train_images, train_labels, 1);
+        double single_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        std::vector<HogwildStats> stats = hogwild.trainEpoch(train_images, train_labels, threads);
+        double hogwild_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "\nEpoch " << e + 1 << std::endl;
+        std::cout << "  Serial            : " << testAccuracy(serial, test_images, test_labels) << "% | "
+                  << train_images.size() / serial_seconds << " samples/s" << std::endl;
+        std::cout << "  Hogwild 1 thread  : " << testAccuracy(single, test_images, test_labels) << "% | "
+                  << train_images.size() / single_seconds << " samples/s" << std::endl;
+        std::cout << "  Hogwild " << std::setw(2) << threads << " threads: "
+                  << testAccuracy(shared, test_images, test_labels) << "% | "
+                  << train_images.size() / hogwild_seconds << " samples/s ("
+                  << single_seconds / hogwild_seconds << "x the 1 thread kernel)" << std::endl;
+        for (size_t t = 0; t < stats.size(); t++)
+        {
+            std::cout << "    thread " << t << " : " << stats[t].samples << " samples, staleness mean "
+                      << stats[t].meanStaleness() << " max " << stats[t].max_staleness << std::endl;
+        }
+    }
+    return 0;
+}
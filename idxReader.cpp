@@ -0,0 +1,269 @@
+#include "idxReader.h"
+#include <iostream>
+#include <cstring>   // For memcpy
+#include <cstdint>
+#include <algorithm> // For std::min
+
+#include <fcntl.h>    // For open, posix_fadvise
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For pread, close
+
+size_t IdxHeader::recordCount() const {
+    return dims.empty() ? 0 : (size_t)dims[0];
+}
+
+size_t IdxHeader::recordSize() const {
+    size_t size = 1;
+    for (size_t i = 1; i < dims.size(); i++) {
+        size *= (size_t)dims[i];
+    }
+    return size;
+}
+
+// Helpers : big-endian bytes -> numbers
+// Same idea as readInt in mnistParser.cpp : first byte is the most significant
+static uint16_t readBig16(const unsigned char *p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static uint32_t readBig32(const unsigned char *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+static uint64_t readBig64(const unsigned char *p) {
+    return (uint64_t)readBig32(p) << 32 | readBig32(p + 4);
+}
+
+static size_t elementSize(unsigned char type) {
+    switch (type) {
+        case 0x08: case 0x09: return 1;
+        case 0x0B: return 2;
+        case 0x0C: case 0x0D: return 4;
+        case 0x0E: return 8;
+        default: return 0; // Unknown type
+    }
+}
+
+// Read the header from an open file descriptor, check it against the file size
+static bool parseHeader(int fd, const std::string &filename, IdxHeader &header) {
+    unsigned char magic[4];
+    if (pread(fd, magic, 4, 0) != 4) {
+        std::cerr << "[ERROR] IDX file too short: " << filename << std::endl;
+        return false;
+    }
+    size_t element = elementSize(magic[2]);
+    int rank = magic[3];
+    if (magic[0] != 0 || magic[1] != 0 || element == 0 || rank == 0) {
+        std::cerr << "[ERROR] Not an IDX file (bad magic number): " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> dim_bytes(4 * rank);
+    if (pread(fd, dim_bytes.data(), dim_bytes.size(), 4) != (ssize_t)dim_bytes.size()) {
+        std::cerr << "[ERROR] IDX header is truncated: " << filename << std::endl;
+        return false;
+    }
+
+    header.type = (IdxType)magic[2];
+    header.element_size = element;
+    header.data_offset = 4 + 4 * (size_t)rank;
+    header.dims.resize(rank);
+    for (int i = 0; i < rank; i++) {
+        header.dims[i] = (int)readBig32(&dim_bytes[4 * i]);
+        if (header.dims[i] < 0) {
+            std::cerr << "[ERROR] IDX dimension is negative: " << filename << std::endl;
+            return false;
+        }
+    }
+
+    struct stat info;
+    size_t needed = header.data_offset + header.recordCount() * header.recordSize() * element;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < needed) {
+        std::cerr << "[ERROR] IDX file is smaller than its header says: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace IdxReader {
+
+    bool readHeader(const std::string &filename, IdxHeader &header) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "[ERROR] Cannot open file: " << filename << std::endl;
+            return false;
+        }
+        bool ok = parseHeader(fd, filename, header);
+        close(fd);
+        return ok;
+    }
+
+    // Convert
+    /*
+        Every type gets its own loop so the type check is not repeated per element.
+        Multi-byte types are big-endian in the file : flip while converting.
+        Floats are flipped as raw bits and then reinterpreted (memcpy is the safe way).
+    */
+    void convert(const unsigned char *raw, IdxType type, size_t count, double scale, double *out) {
+        switch (type) {
+            case IdxType::UInt8:
+                for (size_t i = 0; i < count; i++) out[i] = raw[i] * scale;
+                break;
+            case IdxType::Int8:
+                for (size_t i = 0; i < count; i++) out[i] = (signed char)raw[i] * scale;
+                break;
+            case IdxType::Int16:
+                for (size_t i = 0; i < count; i++) out[i] = (int16_t)readBig16(raw + 2 * i) * scale;
+                break;
+            case IdxType::Int32:
+                for (size_t i = 0; i < count; i++) out[i] = (int32_t)readBig32(raw + 4 * i) * scale;
+                break;
+            case IdxType::Float32:
+                for (size_t i = 0; i < count; i++) {
+                    uint32_t bits = readBig32(raw + 4 * i);
+                    float value;
+                    std::memcpy(&value, &bits, 4);
+                    out[i] = value * scale;
+                }
+                break;
+            case IdxType::Float64:
+                for (size_t i = 0; i < count; i++) {
+                    uint64_t bits = readBig64(raw + 8 * i);
+                    double value;
+                    std::memcpy(&value, &bits, 8);
+                    out[i] = value * scale;
+                }
+                break;
+        }
+    }
+
+    std::vector<double> loadAll(const std::string &filename, IdxHeader &header, double scale) {
+        std::vector<double> values;
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "[ERROR] Cannot open file: " << filename << std::endl;
+            return values;
+        }
+        if (!parseHeader(fd, filename, header)) {
+            close(fd);
+            return values;
+        }
+
+        size_t count = header.recordCount() * header.recordSize();
+        std::vector<unsigned char> raw(count * header.element_size);
+        size_t done = 0;
+        while (done < raw.size()) {
+            ssize_t got = pread(fd, raw.data() + done, raw.size() - done, header.data_offset + done);
+            if (got <= 0) break;
+            done += got;
+        }
+        close(fd);
+        if (done != raw.size()) {
+            std::cerr << "[ERROR] Could not read IDX data: " << filename << std::endl;
+            return values;
+        }
+
+        values.resize(count);
+        convert(raw.data(), header.type, count, scale, values.data());
+        return values;
+    }
+
+} // namespace IdxReader
+
+// STREAMING READER
+
+IdxStream::IdxStream(const std::string &filename, size_t window, double scale)
+    : fd(-1), window(std::max<size_t>(1, window)), scale(scale), position(0), loaded(0)
+{
+    header.type = IdxType::UInt8;
+    header.element_size = 0;
+    header.data_offset = 0;
+
+    fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[ERROR] Cannot open file: " << filename << std::endl;
+        return;
+    }
+    if (!parseHeader(fd, filename, header)) {
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    // Buffers are sized ONCE for a full window and reused for every chunk
+    raw.resize(this->window * header.recordSize() * header.element_size);
+    values = MatrixStorage(this->window * header.recordSize());
+
+    // Tell the kernel we read front to back and want the first window soon
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    advise(0, this->window, true);
+}
+
+IdxStream::~IdxStream() {
+    if (fd >= 0) close(fd);
+}
+
+// Readahead / eviction hint for a range of records
+// (posix_fadvise is Linux only, elsewhere this does nothing)
+void IdxStream::advise(size_t first_record, size_t records, bool will_need) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    size_t record_bytes = header.recordSize() * header.element_size;
+    records = std::min(records, header.recordCount() - std::min(first_record, header.recordCount()));
+    if (records == 0) return;
+    posix_fadvise(fd, header.data_offset + first_record * record_bytes, records * record_bytes,
+                  will_need ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED);
+#else
+    (void)first_record;
+    (void)records;
+    (void)will_need;
+#endif
+}
+
+size_t IdxStream::next() {
+    if (fd < 0) return 0;
+
+    // The previous window is done : drop its pages from the page cache
+    if (loaded > 0) {
+        advise(position - loaded, loaded, false);
+    }
+
+    loaded = std::min(window, header.recordCount() - position);
+    if (loaded == 0) return 0;
+
+    size_t record_bytes = header.recordSize() * header.element_size;
+    size_t bytes = loaded * record_bytes;
+    size_t offset = header.data_offset + position * record_bytes;
+
+    // Start fetching the window AFTER this one while we convert and train on this one
+    advise(position + loaded, window, true);
+
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t got = pread(fd, raw.data() + done, bytes - done, offset + done);
+        if (got <= 0) {
+            std::cerr << "[ERROR] IDX read failed at record " << position << std::endl;
+            loaded = 0;
+            return 0;
+        }
+        done += got;
+    }
+
+    IdxReader::convert(raw.data(), header.type, loaded * header.recordSize(), scale, values.data());
+    position += loaded;
+    return loaded;
+}
+
+ConstMatrixView IdxStream::chunk() const {
+    return ConstMatrixView(values.data(), (int)loaded, (int)header.recordSize());
+}
+
+void IdxStream::rewind() {
+    if (loaded > 0) {
+        advise(position - loaded, loaded, false);
+    }
+    position = 0;
+    loaded = 0;
+    advise(0, window, true);
+}
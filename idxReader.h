@@ -0,0 +1,119 @@
+#ifndef IDX_READER_H
+#define IDX_READER_H
+
+#include <vector>
+#include <string>
+#include "matrix.h"
+
+/*
+    The Problem : MNISTParser only knows two files.
+    It checks for the magic numbers 2051 / 2049, assumes 1 byte pixels and
+    reads the WHOLE file into RAM. Fine for 60,000 digits, useless for a dataset
+    with tens of millions of samples.
+
+    The IDX format is actually more general. The magic number is really 4 bytes:
+    [Byte 0-1] : Always 0
+    [Byte 2]   : Element type
+                 0x08 unsigned byte  0x09 signed byte  0x0B short (2 bytes)
+                 0x0C int (4 bytes)  0x0D float (4)    0x0E double (8)
+    [Byte 3]   : Rank (number of dimensions)
+    Then one big-endian int per dimension, then the data (also big-endian).
+    MNIST images : type 0x08, rank 3 -> 0x00000803 = 2051. Labels : 0x00000801 = 2049.
+
+    The first dimension is the number of RECORDS (samples), the rest is the shape of
+    one record (28 x 28 for MNIST). Every record becomes a flat row of doubles.
+
+    Two ways to read:
+    - IdxReader::loadAll  : whole file into memory (small datasets)
+    - IdxStream           : a fixed window of records at a time, reusing the same
+                            buffers, so memory use does not depend on dataset size
+*/
+
+enum class IdxType : unsigned char {
+    UInt8 = 0x08,
+    Int8 = 0x09,
+    Int16 = 0x0B,
+    Int32 = 0x0C,
+    Float32 = 0x0D,
+    Float64 = 0x0E
+};
+
+struct IdxHeader {
+    IdxType type;
+    std::vector<int> dims;    // dims[0] = records, the rest = shape of one record
+    size_t element_size;      // Bytes per element
+    size_t data_offset;       // Where the data starts in the file
+
+    size_t recordCount() const;
+    size_t recordSize() const; // Elements per record (product of dims[1..])
+};
+
+namespace IdxReader {
+
+    // Read and validate the header only
+    // Output : false (and an error message) if the file is not a valid IDX file
+    bool readHeader(const std::string &filename, IdxHeader &header);
+
+    // Load every record, converted to double and multiplied by `scale`
+    // (eg. 1.0 / 255.0 for pixels)
+    // Output : records x recordSize values, row-major (record i starts at i * recordSize)
+    std::vector<double> loadAll(const std::string &filename, IdxHeader &header, double scale = 1.0);
+
+    // Big-endian elements -> doubles (count elements)
+    void convert(const unsigned char *raw, IdxType type, size_t count, double scale, double *out);
+
+} // namespace IdxReader
+
+// Streaming Reader
+/*
+    Reads `window` records per call into one reused buffer.
+    - The kernel is told the access is sequential and asked to start reading the
+      NEXT window in the background (posix_fadvise WILLNEED) while we train on this one
+    - Pages of windows we are done with are dropped from the page cache (DONTNEED)
+    So a training run over a file much bigger than RAM keeps a flat memory profile.
+    Reading needs POSIX (open / pread). The hints are Linux only : where posix_fadvise
+    does not exist (eg. macOS) they are skipped and the stream still works, just
+    without the readahead / eviction help.
+
+    Usage:
+        IdxStream images("huge-images.idx3-ubyte", 4096, 1.0 / 255.0);
+        while (images.next() > 0) {
+            ConstMatrixView rows = images.chunk();  // count x recordSize
+            ... rows.transposed() is recordSize x count (one sample per column)
+        }
+        images.rewind(); // next epoch
+*/
+class IdxStream {
+private:
+    int fd;
+    IdxHeader header;
+    size_t window;            // Records per chunk
+    double scale;
+    size_t position;          // Next record to read
+    size_t loaded;            // Records in the current chunk
+    std::vector<unsigned char> raw;  // Reused file bytes of one window
+    MatrixStorage values;            // Reused converted window (huge pages when big)
+
+    void advise(size_t first_record, size_t records, bool will_need); // false : done with them
+
+public:
+    IdxStream(const std::string &filename, size_t window, double scale = 1.0);
+    ~IdxStream();
+
+    IdxStream(const IdxStream &) = delete;
+    IdxStream &operator=(const IdxStream &) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    const IdxHeader &getHeader() const { return header; }
+
+    // Load the next window. Returns the number of records loaded (0 at the end).
+    size_t next();
+
+    // The records of the current window, loaded x recordSize, row-major
+    ConstMatrixView chunk() const;
+
+    // Start over from the first record (next epoch)
+    void rewind();
+};
+
+#endif // IDX_READER_H
@@ -0,0 +1,161 @@
+#include "inferenceModel.h"
+#include "neuralNetwork.h"
+#include "softmax.h"
+#include <cmath>     // For exp
+#include <algorithm> // For std::min
+#include <iostream>
+
+// PACKING
+
+static int paddedRows(int rows) {
+    const int pr = InferenceModel::PANEL_ROWS;
+    return (rows + pr - 1) / pr * pr;
+}
+
+// Panel p, step k holds rows p*PANEL_ROWS ... p*PANEL_ROWS + 3 of column k, side by side
+MatrixStorage InferenceModel::pack(ConstMatrixView weights) {
+    const int pr = PANEL_ROWS;
+    MatrixStorage packed((size_t)paddedRows(weights.rows) * weights.cols);
+    double *out = packed.data();
+    for (int p = 0; p < paddedRows(weights.rows) / pr; p++) {
+        for (int k = 0; k < weights.cols; k++) {
+            for (int r = 0; r < pr; r++) {
+                int row = p * pr + r;
+                *out++ = row < weights.rows ? weights.at(row, k) : 0.0; // Padding rows stay 0
+            }
+        }
+    }
+    return packed;
+}
+
+MatrixStorage InferenceModel::padBias(ConstMatrixView bias) {
+    MatrixStorage padded((size_t)paddedRows(bias.rows));
+    for (int i = 0; i < bias.rows; i++) {
+        padded.data()[i] = bias.at(i, 0);
+    }
+    return padded;
+}
+
+InferenceModel::InferenceModel(const NeuralNetwork &nn)
+    : input_nodes(nn.getInputNodes()), hidden_nodes(nn.getHiddenNodes()), output_nodes(nn.getOutputNodes()),
+      output_head(nn.getOutputHead())
+{
+    // Flat parameter layout : [ weights_ho | bias_o | weights_ih | bias_h ]
+    std::vector<double> params(nn.parameterCount());
+    nn.copyParametersTo(params.data());
+    const double *p = params.data();
+    ConstMatrixView w_ho(p, output_nodes, hidden_nodes);
+    p += output_nodes * hidden_nodes;
+    ConstMatrixView b_o(p, output_nodes, 1);
+    p += output_nodes;
+    ConstMatrixView w_ih(p, hidden_nodes, input_nodes);
+    p += hidden_nodes * input_nodes;
+    ConstMatrixView b_h(p, hidden_nodes, 1);
+
+    panels_ih = pack(w_ih);
+    bias_h = padBias(b_h);
+    panels_ho = pack(w_ho);
+    bias_o = padBias(b_o);
+}
+
+InferenceModel::Workspace::Workspace(const InferenceModel &model, int max_batch)
+    : input((size_t)model.input_nodes * std::max(1, max_batch)),
+      hidden((size_t)model.hidden_nodes * std::max(1, max_batch)),
+      max_batch(std::max(1, max_batch)) {}
+
+// KERNEL
+// Same formula as NeuralNetwork::sigmoid (so frozen outputs match feedForward exactly)
+static inline double sigmoid(double x) {
+    return 1.0 / (1.0 + exp(-x));
+}
+
+/*
+    One layer for `count` samples : y = sigmoid(W * x + bias)   (squash = false : y = W * x + bias)
+    x of sample b starts at x + b * depth, y at y + b * y_sample_stride (rows y_row_stride apart)
+    Panels are the outer loop, so a panel is pulled into cache once and used for every sample.
+    The PANEL_ROWS accumulators stay in registers; the epilogue adds the bias and squashes
+    them on the way out, which is the only time the result touches memory.
+*/
+static void panelLayer(const double *panels, const double *bias, int rows, int depth,
+                       const double *x, int count, double *y, int y_row_stride, int y_sample_stride,
+                       bool squash) {
+    const int pr = InferenceModel::PANEL_ROWS;
+    int panel_count = (rows + pr - 1) / pr;
+    for (int p = 0; p < panel_count; p++) {
+        const double *w = panels + (size_t)p * depth * pr;
+        int base = p * pr;
+        for (int b = 0; b < count; b++) {
+            const double *xb = x + (size_t)b * depth;
+            double acc[pr] = {}; // All zeros
+            for (int k = 0; k < depth; k++) {
+                double xk = xb[k];
+                for (int r = 0; r < pr; r++) {
+                    acc[r] += w[k * pr + r] * xk;
+                }
+            }
+            // Epilogue : bias + activation, padding rows are never written
+            double *yb = y + (size_t)b * y_sample_stride;
+            for (int r = 0; r < pr && base + r < rows; r++) {
+                double sum = acc[r] + bias[base + r];
+                yb[(base + r) * y_row_stride] = squash ? sigmoid(sum) : sum;
+            }
+        }
+    }
+}
+
+// `count` samples stored back to back at `inputs`, results to columns first ... of outputs
+void InferenceModel::predictBatch(const double *inputs, int count, double *hidden, MatrixView outputs,
+                                  int first) const {
+    panelLayer(panels_ih.data(), bias_h.data(), hidden_nodes, input_nodes, inputs, count,
+               hidden, 1, hidden_nodes, true);
+    bool softmax = output_head == OutputHead::SoftmaxCrossEntropy;
+    panelLayer(panels_ho.data(), bias_o.data(), output_nodes, hidden_nodes, hidden, count,
+               &outputs.at(0, first), outputs.row_stride, outputs.col_stride, !softmax);
+    // Softmax head : logits are written, turn each sample's column into probabilities
+    if (softmax) {
+        for (int b = 0; b < count; b++) {
+            Softmax::probabilities(&outputs.at(0, first + b), output_nodes, outputs.row_stride);
+        }
+    }
+}
+
+bool InferenceModel::predict(ConstMatrixView inputs, MatrixView outputs, Workspace &workspace) const {
+    if (inputs.rows != input_nodes || outputs.rows != output_nodes || outputs.cols != inputs.cols) {
+        std::cerr << "Error: Input / Output view size does not match the model." << std::endl;
+        return false;
+    }
+    if (workspace.input.size() < (size_t)input_nodes * workspace.max_batch
+        || workspace.hidden.size() < (size_t)hidden_nodes * workspace.max_batch) {
+        std::cerr << "Error: Workspace was made for a different model." << std::endl;
+        return false;
+    }
+
+    for (int first = 0; first < inputs.cols; first += workspace.max_batch) {
+        int count = std::min(workspace.max_batch, inputs.cols - first);
+        // Gather the samples into one aligned, contiguous block (any input strides work)
+        double *gathered = workspace.input.data();
+        for (int b = 0; b < count; b++) {
+            for (int k = 0; k < input_nodes; k++) {
+                gathered[(size_t)b * input_nodes + k] = inputs.at(k, first + b);
+            }
+        }
+        predictBatch(gathered, count, workspace.hidden.data(), outputs, first);
+    }
+    return true;
+}
+
+std::vector<double> InferenceModel::predict(const std::vector<double> &input) const {
+    if (input.size() != (size_t)input_nodes) {
+        std::cerr << "Error: Input size does not match number of input nodes." << std::endl;
+        return std::vector<double>();
+    }
+    // One hidden buffer per thread, grown only when a bigger model comes along
+    thread_local MatrixStorage hidden;
+    if (hidden.size() < (size_t)hidden_nodes) {
+        hidden = MatrixStorage(hidden_nodes);
+    }
+    // The vector is already contiguous : no gather needed
+    std::vector<double> result(output_nodes);
+    predictBatch(input.data(), 1, hidden.data(), MatrixView::column(result.data(), output_nodes), 0);
+    return result;
+}
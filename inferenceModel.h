@@ -0,0 +1,85 @@
+#ifndef INFERENCE_MODEL_H
+#define INFERENCE_MODEL_H
+
+#include <vector>
+#include "matrix.h"
+
+class NeuralNetwork;
+enum class OutputHead; // neuralNetwork.h
+
+/*
+    The Problem : A trained network still carries training baggage.
+    NeuralNetwork::feedForward allocates a hidden Matrix on every call, multiplies
+    through the general (any shape, any stride) kernel, then walks the result two
+    more times : once to add the bias, once to apply the sigmoid. For a server that
+    answers one request at a time, that is 3 passes and a heap allocation per layer.
+
+    The Fix : freeze() the network into an InferenceModel
+    - Weights are copied ONCE into the "panel" layout the kernel below reads :
+      PANEL_ROWS output rows side by side, walked down k together
+          panel 0 : w[0][0] w[1][0] w[2][0] w[3][0] | w[0][1] w[1][1] ... (k = 0, 1, ...)
+      so every input number is loaded once and used for PANEL_ROWS outputs, and the
+      weights stream through memory in exactly the order they are used.
+    - Bias add and sigmoid happen while each result is still in a register
+      (the "epilogue" of the multiply), no extra passes. A softmax head needs the
+      whole column, so its output layer stops at bias and softmax runs per sample after.
+    - Every buffer is a MatrixStorage (64-byte aligned, same policy as Matrix) and
+      allocated up front. Scratch space lives in a Workspace owned by the caller.
+
+    THREAD SAFETY
+    Nothing inside an InferenceModel ever changes after it is built, and every
+    per-request buffer lives in a Workspace. Any number of threads can call predict()
+    on the same model at once, no locks : each brings its own Workspace (or uses the
+    vector overload, which keeps one per thread).
+
+    Results are the same numbers feedForward gives : every dot product adds its k terms
+    in the same order, starting from 0, before the bias is added.
+*/
+
+class InferenceModel {
+public:
+    // Output rows per weight panel (4 doubles = one 256-bit register)
+    static const int PANEL_ROWS = 4;
+
+    // Per-thread scratch : gathered inputs and hidden layer for up to max_batch samples
+    class Workspace {
+    private:
+        friend class InferenceModel;
+        MatrixStorage input, hidden;
+        int max_batch;
+
+    public:
+        Workspace(const InferenceModel &model, int max_batch = 1);
+    };
+
+    // Packs the network's current weights (use NeuralNetwork::freeze())
+    explicit InferenceModel(const NeuralNetwork &nn);
+
+    // inputs : input_nodes x B, outputs : output_nodes x B (one sample per column)
+    // Batches bigger than the workspace are done in workspace-sized pieces.
+    // Returns false on a size mismatch.
+    bool predict(ConstMatrixView inputs, MatrixView outputs, Workspace &workspace) const;
+
+    // One sample, same interface as NeuralNetwork::feedForward
+    // Uses a workspace that belongs to the calling thread (allocated on its first call)
+    std::vector<double> predict(const std::vector<double> &input) const;
+
+    int getInputNodes() const { return input_nodes; }
+    int getHiddenNodes() const { return hidden_nodes; }
+    int getOutputNodes() const { return output_nodes; }
+    OutputHead getOutputHead() const { return output_head; }
+
+private:
+    int input_nodes, hidden_nodes, output_nodes;
+    OutputHead output_head;
+
+    // Panel-packed weights (rows padded to a multiple of PANEL_ROWS with zeros) and biases
+    MatrixStorage panels_ih, bias_h;
+    MatrixStorage panels_ho, bias_o;
+
+    static MatrixStorage pack(ConstMatrixView weights);
+    static MatrixStorage padBias(ConstMatrixView bias);
+    void predictBatch(const double *inputs, int count, double *hidden, MatrixView outputs, int first) const;
+};
+
+#endif // INFERENCE_MODEL_H
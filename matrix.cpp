@@ -1,16 +1,71 @@
-#include "Matrix.h" // Links out header file
+#include "matrix.h" // Links out header file
 #include <cmath> // For math functions
 #include <cstdlib> // For rand()
 #include <ctime> // For seeding time
 #include <iostream> // For printing
+#include <algorithm> // For std::min, std::max
+#include <mutex> // Serializes writers of the tuned settings table
+#include <atomic>
+#include <memory> // For std::shared_ptr (settings table snapshots)
+#include "threadPool.h" // Shared workers for big kernels
+
+// Views
+// Dense row-major: moving one row skips `cols` numbers, moving one column skips 1
+MatrixView::MatrixView(double *data, int rows, int cols)
+    : data(data), rows(rows), cols(cols), row_stride(cols), col_stride(1) {}
+
+MatrixView::MatrixView(double *data, int rows, int cols, int row_stride, int col_stride)
+    : data(data), rows(rows), cols(cols), row_stride(row_stride), col_stride(col_stride) {}
+
+MatrixView MatrixView::column(double *data, int n) {
+    return MatrixView(data, n, 1, 1, 1);
+}
+
+// Transpose without touching memory : swap the shape and swap the strides
+MatrixView MatrixView::transposed() const {
+    return MatrixView(data, cols, rows, col_stride, row_stride);
+}
+
+ConstMatrixView::ConstMatrixView(const double *data, int rows, int cols)
+    : data(data), rows(rows), cols(cols), row_stride(cols), col_stride(1) {}
+
+ConstMatrixView::ConstMatrixView(const double *data, int rows, int cols, int row_stride, int col_stride)
+    : data(data), rows(rows), cols(cols), row_stride(row_stride), col_stride(col_stride) {}
+
+ConstMatrixView::ConstMatrixView(const MatrixView &v)
+    : data(v.data), rows(v.rows), cols(v.cols), row_stride(v.row_stride), col_stride(v.col_stride) {}
+
+ConstMatrixView ConstMatrixView::column(const double *data, int n) {
+    return ConstMatrixView(data, n, 1, 1, 1);
+}
+
+ConstMatrixView ConstMatrixView::column(const std::vector<double> &values) {
+    return column(values.data(), (int)values.size());
+}
+
+ConstMatrixView ConstMatrixView::transposed() const {
+    return ConstMatrixView(data, cols, rows, col_stride, row_stride);
+}
 
 // 1. Constructor
 Matrix::Matrix(int r, int c) {
     // TODO: Assign rows, cols, and resize data
     rows = r;
     cols = c;
-    //memory allocation for the vector
-    data.resize(rows * cols, 0.0); //row x col slots needed and all initialzed with zero
+    //memory allocation (aligned, see matrixStorage.h)
+    data = MatrixStorage((size_t)rows * cols); //row x col slots needed and all initialzed with zero
+}
+
+Matrix::Matrix(int r, int c, const StoragePolicy &policy)
+    : rows(r), cols(c), data((size_t)r * c, policy) {}
+
+// Owning copy of a view
+Matrix::Matrix(ConstMatrixView v) : Matrix(v.rows, v.cols) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            at(i, j) = v.at(i, j);
+        }
+    }
 }
 
 // 2. The Accessor
@@ -29,6 +84,14 @@ const double& Matrix::at(int r, int c) const {
     return data[(r * cols) + c];
 }
 
+MatrixView Matrix::view() {
+    return MatrixView(data.data(), rows, cols);
+}
+
+ConstMatrixView Matrix::view() const {
+    return ConstMatrixView(data.data(), rows, cols);
+}
+
 // 3. Print (So you can see what you built)
 void Matrix::print() {
     // TODO: Double loop to print
@@ -73,115 +136,375 @@ void Matrix::randomize() {
 }
 
 // 5. Transpose (Flip rows and columns)
-Matrix Matrix::transpose() {
+Matrix Matrix::transpose() const {
     Matrix result(cols, rows); // Note the flipped dimensions
-    for(int i = 0 ;i < rows; i++){
-        for(int j = 0 ; j < cols; j++){
-            // Put the value at (i,j) into (j,i)
-            result.at(j, i) = at(i,j);
-        }
-    }
+    transpose(view(), result.view());
     return result;
 }
 
 // 6. Multiply by Scalar (Scale the matrix)
-Matrix Matrix::multiplyScalar(double scalar) {
+Matrix Matrix::multiplyScalar(double scalar) const {
     Matrix result(rows, cols); // Same dimensions
-    for(int i = 0; i < rows; i++){
-        for(int j = 0; j < cols; j++){
-            result.at(i,j) = at(i,j) * scalar;
-        }
-    }
+    multiplyScalar(view(), scalar, result.view());
     return result;
 }
 
 // 7. Add another Matrix
-Matrix Matrix::add(const Matrix &m){
-    if(rows != m.rows || cols != m.cols){
-        std::cerr << "Error : Matrix dimensions Mismatch in addition. " << std::endl;
+Matrix Matrix::add(const Matrix &m) const {
+    Matrix result(rows, cols); // Same dimensions
+    if (!add(view(), m.view(), result.view())) {
+        return Matrix(0,0); // Return empty matrix on error
+    }
+    return result;
+}
+
+// 8. Multiply by another Matrix
+Matrix Matrix::multiply(const Matrix &m) const {
+    Matrix result(rows, m.cols); // New dimensions
+    if (!multiply(view(), m.view(), result.view())) {
         return Matrix(0,0); // Return empty matrix on error
     }
+    return result;
+}
 
+// 9. Map Function (Apply a function to every element)
+Matrix Matrix::map(double (*func)(double)) const {
+    Matrix result(rows, cols);
+    map(view(), func, result.view());
+    return result;
+}
+
+// Substraction function 
+Matrix Matrix::subtract(const Matrix &m) const {
     Matrix result(rows, cols); // Same dimensions
-    for(int i = 0; i < rows; i++){
-        for(int j = 0; j < cols; j++){
-            result.at(i,j) = at(i,j) + m.at(i,j);
-        }
+    if (!subtract(view(), m.view(), result.view())) {
+        return Matrix(0,0); // Return empty matrix on error
     }
     return result;
 }
 
-// 8. Multiply by another Matrix
-Matrix Matrix::multiply(const Matrix &m){
-    if(cols != m.rows){
-        std::cerr << "Error : Matrix dimensions Mismatch in multiplication. " << std::endl;
+// Hadamard Product (Element-wise multiplication)
+Matrix Matrix::multiplyHadamard(const Matrix &m) const {
+    Matrix result(rows, cols); // Same dimensions
+    if (!multiplyHadamard(view(), m.view(), result.view())) {
         return Matrix(0,0); // Return empty matrix on error
     }
+    return result;
+}
 
-    Matrix result(rows, m.cols); // New dimensions
-    for(int i = 0; i < rows; i++){
-        for(int j = 0; j < m.cols; j++){
-            double sum = 0.0;
-            for(int k = 0; k < cols; k++){ // or k < m.rows
-                sum += at(i,k) * m.at(k,j);
+// KERNELS ON VIEWS
+// These do the real work. The Matrix methods above are thin wrappers that
+// allocate the result and pass views of their own memory in.
+
+// Helper : same shape check for the elementwise kernels
+static bool sameShape(const ConstMatrixView &a, int rows, int cols, const char *what) {
+    if (a.rows != rows || a.cols != cols) {
+        std::cerr << "Error : Matrix dimensions Mismatch in " << what << ". " << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Parallel grain (see matrix.h), in operations per piece
+static std::atomic<long> parallel_grain(32768);
+
+void Matrix::setParallelGrain(long operations) {
+    parallel_grain.store(std::max(1L, operations));
+}
+
+long Matrix::getParallelGrain() {
+    return parallel_grain.load();
+}
+
+// Helper : run body(first_row, last_row) over all rows, in parallel when big enough
+// Every piece owns whole rows of the result, so pieces never write the same element.
+template <typename RowBody>
+static void forRowBlocks(int rows, long ops_per_row, RowBody body) {
+    long grain_rows = std::max(1L, parallel_grain.load() / std::max(1L, ops_per_row));
+    if (rows <= grain_rows) {
+        body(0, rows); // Too small to be worth a hand-off
+        return;
+    }
+    ThreadPool::global().parallelFor(rows, grain_rows, [&](long begin, long end) {
+        body((int)begin, (int)end);
+    });
+}
+
+// Transpose : out(j, i) = a(i, j)
+// Split over result rows, so every piece writes its own rows of out
+bool Matrix::transpose(ConstMatrixView a, MatrixView out) {
+    if (!sameShape(a, out.cols, out.rows, "transpose")) return false;
+    forRowBlocks(out.rows, out.cols, [&](int first, int last) {
+        for (int j = first; j < last; j++) {
+            for (int i = 0; i < a.rows; i++) {
+                out.at(j, i) = a.at(i, j);
             }
-            result.at(i,j) = sum;
         }
-    }
-    return result;
+    });
+    return true;
 }
 
-// 9. Map Function (Apply a function to every element)
-// Inside Matrix.cpp
+bool Matrix::multiplyScalar(ConstMatrixView a, double scalar, MatrixView out) {
+    if (!sameShape(a, out.rows, out.cols, "scalar multiplication")) return false;
+    forRowBlocks(a.rows, a.cols, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            for (int j = 0; j < a.cols; j++) {
+                out.at(i, j) = a.at(i, j) * scalar;
+            }
+        }
+    });
+    return true;
+}
 
-Matrix Matrix::map(double (*func)(double)) {
-    Matrix result(rows, cols);
+bool Matrix::add(ConstMatrixView a, ConstMatrixView b, MatrixView out) {
+    if (!sameShape(b, a.rows, a.cols, "addition")) return false;
+    if (!sameShape(out, a.rows, a.cols, "addition")) return false;
+    forRowBlocks(a.rows, a.cols, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            for (int j = 0; j < a.cols; j++) {
+                out.at(i, j) = a.at(i, j) + b.at(i, j);
+            }
+        }
+    });
+    return true;
+}
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            // 1. Get the original value
-            double val = at(i, j);
-            
-            // 2. Apply the function (Sigmoid) to it
-            double activated = func(val);
-            
-            // 3. Store it in the result
-            result.at(i, j) = activated;
+bool Matrix::subtract(ConstMatrixView a, ConstMatrixView b, MatrixView out) {
+    if (!sameShape(b, a.rows, a.cols, "subtraction")) return false;
+    if (!sameShape(out, a.rows, a.cols, "subtraction")) return false;
+    forRowBlocks(a.rows, a.cols, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            for (int j = 0; j < a.cols; j++) {
+                out.at(i, j) = a.at(i, j) - b.at(i, j);
+            }
         }
-    }
-    return result;
+    });
+    return true;
 }
 
-// Substraction function 
-Matrix Matrix::subtract(const Matrix &m){
-    if(rows != m.rows || cols != m.cols){
-        std::cerr << "Error : Matrix dimensions Mismatch in subtraction. " << std::endl;
-        return Matrix(0,0); // Return empty matrix on error
+bool Matrix::multiplyHadamard(ConstMatrixView a, ConstMatrixView b, MatrixView out) {
+    if (!sameShape(b, a.rows, a.cols, "Hadamard multiplication")) return false;
+    if (!sameShape(out, a.rows, a.cols, "Hadamard multiplication")) return false;
+    forRowBlocks(a.rows, a.cols, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            for (int j = 0; j < a.cols; j++) {
+                out.at(i, j) = a.at(i, j) * b.at(i, j);
+            }
+        }
+    });
+    return true;
+}
+
+// map costs a function call (often an exp) per element, so count it as 8 operations
+bool Matrix::map(ConstMatrixView a, double (*func)(double), MatrixView out) {
+    if (!sameShape(a, out.rows, out.cols, "map")) return false;
+    forRowBlocks(a.rows, 8L * a.cols, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            for (int j = 0; j < a.cols; j++) {
+                out.at(i, j) = func(a.at(i, j));
+            }
+        }
+    });
+    return true;
+}
+
+// Bias on a batch : every column of `a` gets the same n x 1 column added
+bool Matrix::addColumn(ConstMatrixView a, ConstMatrixView column, MatrixView out) {
+    if (!sameShape(column, a.rows, 1, "column addition")) return false;
+    if (!sameShape(out, a.rows, a.cols, "column addition")) return false;
+    forRowBlocks(a.rows, a.cols, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            double c = column.at(i, 0);
+            for (int j = 0; j < a.cols; j++) {
+                out.at(i, j) = a.at(i, j) + c;
+            }
+        }
+    });
+    return true;
+}
+
+// Matrix product : out = a * b
+// out(i, j) = sum over k of a(i, k) * b(k, j)
+bool Matrix::multiply(ConstMatrixView a, ConstMatrixView b, MatrixView out) {
+    return multiply(a, b, out, gemmConfigFor(a.rows, b.cols, a.cols));
+}
+
+// Helper : one block of the result, rows [row_begin, row_end) x cols [col_begin, col_end)
+/*
+    Naive i-j-k walks the WHOLE of b for every row of a. When b is bigger than the
+    cache, every row reloads it from memory. Tiling works on a tile_m x tile_n block
+    of the result and a tile_k slice of the shared dimension at a time, so the slices
+    of a and b in use fit in cache and get reused.
+    Every tile ADDS into the result, and the k tiles are visited in order, so each
+    result still adds its terms in exactly the order of the naive loop.
+*/
+static void multiplyBlock(const ConstMatrixView &a, const ConstMatrixView &b, const MatrixView &out,
+                          const GemmConfig &config, int row_begin, int row_end, int col_begin, int col_end) {
+    int depth = a.cols;
+    int tm = std::max(1, config.tile_m);
+    int tn = std::max(1, config.tile_n);
+    int tk = std::max(1, config.tile_k);
+
+    for (int i = row_begin; i < row_end; i++) {
+        for (int j = col_begin; j < col_end; j++) {
+            out.at(i, j) = 0.0;
+        }
     }
 
-    Matrix result(rows, cols); // Same dimensions
-    for(int i = 0; i < rows; i++){
-        for(int j = 0; j < cols; j++){
-            result.at(i,j) = at(i,j) - m.at(i,j);
+    // Contiguous rows in b and out let the i-k-j inner loop run on plain pointers (SIMD)
+    bool unit_stride = b.col_stride == 1 && out.col_stride == 1;
+
+    for (int ii = row_begin; ii < row_end; ii += tm) {
+        int i_end = std::min(ii + tm, row_end);
+        for (int jj = col_begin; jj < col_end; jj += tn) {
+            int j_end = std::min(jj + tn, col_end);
+            for (int kk = 0; kk < depth; kk += tk) {
+                int k_end = std::min(kk + tk, depth);
+
+                if (config.loop_order == 0) {
+                    // i-j-k : one running dot product per result
+                    for (int i = ii; i < i_end; i++) {
+                        for (int j = jj; j < j_end; j++) {
+                            double sum = out.at(i, j);
+                            for (int k = kk; k < k_end; k++) {
+                                sum += a.at(i, k) * b.at(k, j);
+                            }
+                            out.at(i, j) = sum;
+                        }
+                    }
+                } else {
+                    // i-k-j : scale a row of b by a(i, k) and add it to a row of the result
+                    for (int i = ii; i < i_end; i++) {
+                        for (int k = kk; k < k_end; k++) {
+                            double aik = a.at(i, k);
+                            if (unit_stride) {
+                                double *o = &out.at(i, 0);
+                                const double *row = &b.at(k, 0);
+                                for (int j = jj; j < j_end; j++) {
+                                    o[j] += aik * row[j];
+                                }
+                            } else {
+                                for (int j = jj; j < j_end; j++) {
+                                    out.at(i, j) += aik * b.at(k, j);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
         }
     }
-    return result;
 }
 
+bool Matrix::multiply(ConstMatrixView a, ConstMatrixView b, MatrixView out, const GemmConfig &config) {
+    if (a.cols != b.rows || out.rows != a.rows || out.cols != b.cols) {
+        std::cerr << "Error : Matrix dimensions Mismatch in multiplication. " << std::endl;
+        return false;
+    }
+    if (out.rows == 0 || out.cols == 0) return true;
+
+    // The result is cut into tile_m x tile_n tiles. Each pool piece computes a run of
+    // whole tiles, so no two pieces ever write the same element.
+    int tm = std::max(1, config.tile_m);
+    int tn = std::max(1, config.tile_n);
+    long tiles_m = (out.rows + tm - 1) / tm;
+    long tiles_n = (out.cols + tn - 1) / tn;
+    long tiles = tiles_m * tiles_n;
+    long grain_tiles;
+    if (config.threads > 1) {
+        // Tuned thread count : trust the measurement, just cut the tiles into that many runs
+        grain_tiles = (tiles + config.threads - 1) / config.threads;
+    } else {
+        long ops_per_tile = (long)std::min(tm, out.rows) * std::min(tn, out.cols) * std::max(1, a.cols);
+        grain_tiles = std::max(1L, parallel_grain.load() / ops_per_tile);
+    }
 
-// Hadamard Product (Element-wise multiplication)
-Matrix Matrix::multiplyHadamard(const Matrix &m){
-    
-    if(rows != m.rows || cols != m.cols){
-        std::cerr << "Error : Matrix dimensions Mismatch in Hadamard multiplication. " << std::endl;
-        return Matrix(0,0); // Return empty matrix on error
+    if (config.threads == 1 || tiles <= grain_tiles) {
+        multiplyBlock(a, b, out, config, 0, out.rows, 0, out.cols);
+        return true;
     }
+    ThreadPool::global().parallelFor(tiles, grain_tiles, [&](long first, long last) {
+        for (long t = first; t < last; t++) {
+            int ti = (int)(t / tiles_n);
+            int tj = (int)(t % tiles_n);
+            multiplyBlock(a, b, out, config, ti * tm, std::min(out.rows, (ti + 1) * tm),
+                          tj * tn, std::min(out.cols, (tj + 1) * tn));
+        }
+    }, config.threads);
+    return true;
+}
 
-    Matrix result(rows, cols); // Same dimensions
-    for(int i = 0; i < rows; i++){
-        for(int j = 0; j < cols; j++){
-            result.at(i,j) = at(i,j) * m.at(i,j);
+// TUNED SETTINGS TABLE
+/*
+    Every multiply() asks for its settings, so the lookup is on the hot path of every
+    tiny per-sample product, from many threads at once.
+    - The table is an immutable snapshot : setGemmConfig copies it, changes the copy and
+      publishes it with one atomic swap. Readers never lock.
+    - Each thread remembers the answer per exact shape (the network only has a handful),
+      tagged with the table generation. A repeat shape costs one atomic load + a short scan,
+      a new table makes every thread look its shapes up again.
+*/
+namespace {
+    struct GemmEntry {
+        int m, n, k;
+        GemmConfig config;
+    };
+    typedef std::vector<GemmEntry> GemmTable;
+
+    std::mutex gemm_writer_lock; // Writers only (setGemmConfig)
+    std::atomic<std::shared_ptr<const GemmTable>> gemm_table(std::make_shared<const GemmTable>());
+    std::atomic<unsigned long> gemm_generation(0);
+
+    // Closest known shape, measured as how many "doublings" away each dimension is
+    GemmConfig closestConfig(const GemmTable &table, int m, int n, int k) {
+        GemmConfig fallback;
+        fallback.loop_order = n < 8 ? 0 : 1; // Thin results (eg. one sample) are dot products
+
+        const GemmEntry *best = nullptr;
+        double best_distance = 3.0; // Further than this, the tuning says nothing about us
+        for (const GemmEntry &e : table) {
+            double distance = std::fabs(std::log2((double)std::max(1, e.m) / std::max(1, m)))
+                            + std::fabs(std::log2((double)std::max(1, e.n) / std::max(1, n)))
+                            + std::fabs(std::log2((double)std::max(1, e.k) / std::max(1, k)));
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = &e;
+            }
         }
+        return best ? best->config : fallback;
     }
-    return result;
+}
+
+void Matrix::setGemmConfig(int m, int n, int k, const GemmConfig &config) {
+    std::lock_guard<std::mutex> guard(gemm_writer_lock);
+    std::shared_ptr<GemmTable> next = std::make_shared<GemmTable>(*gemm_table.load());
+    bool found = false;
+    for (GemmEntry &e : *next) {
+        if (e.m == m && e.n == n && e.k == k) {
+            e.config = config;
+            found = true;
+        }
+    }
+    if (!found) next->push_back({m, n, k, config});
+    gemm_table.store(std::move(next));
+    gemm_generation.fetch_add(1, std::memory_order_release); // After the store : memos go stale
+}
+
+GemmConfig Matrix::gemmConfigFor(int m, int n, int k) {
+    thread_local GemmTable memo;
+    thread_local unsigned long memo_generation = 0;
+
+    unsigned long generation = gemm_generation.load(std::memory_order_acquire);
+    if (generation != memo_generation) {
+        memo.clear();
+        memo_generation = generation;
+    }
+    for (const GemmEntry &e : memo) {
+        if (e.m == m && e.n == n && e.k == k) return e.config;
+    }
+
+    GemmConfig config = closestConfig(*gemm_table.load(), m, n, k);
+    if (memo.size() >= 64) memo.clear(); // Shapes keep changing : do not grow forever
+    memo.push_back({m, n, k, config});
+    return config;
 }
@@ -1,27 +1,133 @@
 #ifndef MATRIX_H // Guard to prevent multiple inclusions
-#define MATRIX_H // 
+#define MATRIX_H //
 
 #include <vector>
 #include <iostream>
+#include "matrixStorage.h" // Aligned / huge page memory
+
+/*
+    Views : a window into memory somebody else owns
+    A view is just (pointer, rows, cols, row_stride, col_stride). It never allocates
+    and never frees. Element (r, c) lives at data[r * row_stride + c * col_stride].
+    - A std::vector<double> of 784 pixels can be seen as a 784 x 1 column, no copy
+    - Row i of a flat dataset buffer is just a pointer offset
+    - Swapping the two strides gives the transpose for free
+    The owner must outlive the view.
+*/
+class MatrixView {
+public:
+    double *data;
+    int rows, cols;
+    int row_stride, col_stride;
+
+    // Default strides = dense row-major (like Matrix)
+    MatrixView(double *data, int rows, int cols);
+    MatrixView(double *data, int rows, int cols, int row_stride, int col_stride);
+
+    // A contiguous list of numbers as an n x 1 column
+    static MatrixView column(double *data, int n);
+
+    double &at(int r, int c) const { return data[r * row_stride + c * col_stride]; }
+    MatrixView transposed() const;
+};
+
+// Same as MatrixView but read-only (for operands)
+class ConstMatrixView {
+public:
+    const double *data;
+    int rows, cols;
+    int row_stride, col_stride;
+
+    ConstMatrixView(const double *data, int rows, int cols);
+    ConstMatrixView(const double *data, int rows, int cols, int row_stride, int col_stride);
+    ConstMatrixView(const MatrixView &v); // Writable views can always be read
+
+    static ConstMatrixView column(const double *data, int n);
+    static ConstMatrixView column(const std::vector<double> &values);
+
+    const double &at(int r, int c) const { return data[r * row_stride + c * col_stride]; }
+    ConstMatrixView transposed() const;
+};
+
+// Multiply Kernel Settings
+/*
+    The product is computed tile by tile so the pieces being worked on stay in cache:
+    tile_m rows of the result x tile_n columns, walking k (the shared dimension) in
+    steps of tile_k. What is fastest depends on the CPU (cache sizes, SIMD width),
+    which is why GemmTuner measures it per machine.
+    loop_order 0 (i-j-k) : every result is one dot product, best for thin results (B = 1)
+    loop_order 1 (i-k-j) : streams whole rows of b, vectorizes well on wide results
+    Every setting adds the k terms in the same order, so they all give identical results.
+    Result tiles are independent, so they are handed to the shared ThreadPool as pieces.
+*/
+struct GemmConfig {
+    int tile_m = 64;
+    int tile_n = 256;
+    int tile_k = 256;
+    int loop_order = 1;
+    // Pool pieces to split into :
+    // 0 = decided by the parallel grain, 1 = never split,
+    // N > 1 = up to N pieces, no grain check (a measured decision, eg. from GemmTuner)
+    int threads = 0;
+};
 
 class Matrix {
 private:
     int rows, cols;
-    std::vector<double> data;
+    MatrixStorage data; // 64-byte aligned, huge pages when big (see matrixStorage.h)
 public:
     Matrix(int r, int c);
+    Matrix(int r, int c, const StoragePolicy &policy); // Own storage policy instead of the default
+    explicit Matrix(ConstMatrixView v); // Owning copy of a view
     double& at(int r, int c);
     const double& at(int r, int c) const;
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+
+    // Views of this matrix's own memory
+    MatrixView view();
+    ConstMatrixView view() const;
+
     // Utility functions
     void randomize();
     void print();
-    Matrix transpose();
-    Matrix multiplyScalar(double scalar);
-    Matrix add(const Matrix &m);
-    Matrix subtract(const Matrix& m);
-    Matrix multiply(const Matrix &m);
-    Matrix map(double (*func)(double));
-    Matrix multiplyHadamard(const Matrix &m);
+    Matrix transpose() const;
+    Matrix multiplyScalar(double scalar) const;
+    Matrix add(const Matrix &m) const;
+    Matrix subtract(const Matrix& m) const;
+    Matrix multiply(const Matrix &m) const;
+    Matrix map(double (*func)(double)) const;
+    Matrix multiplyHadamard(const Matrix &m) const;
+
+    // Kernels on views
+    // Same math as above, but operands and destination are views, nothing is allocated.
+    // The destination must already have the right shape.
+    // Return false (and print an error) on a dimension mismatch.
+    // Elementwise kernels may write in place (out == a), multiply / transpose may not.
+    static bool multiply(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+    static bool multiply(ConstMatrixView a, ConstMatrixView b, MatrixView out, const GemmConfig &config);
+    static bool add(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+    static bool subtract(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+    static bool multiplyHadamard(ConstMatrixView a, ConstMatrixView b, MatrixView out);
+    static bool multiplyScalar(ConstMatrixView a, double scalar, MatrixView out);
+    static bool map(ConstMatrixView a, double (*func)(double), MatrixView out);
+    static bool transpose(ConstMatrixView a, MatrixView out);
+    // out = a + column (the n x 1 column is added to every column of a, eg. bias on a batch)
+    static bool addColumn(ConstMatrixView a, ConstMatrixView column, MatrixView out);
+
+    // Tuned multiply settings per shape (m x k) * (k x n), filled in by GemmTuner.
+    // multiply() without a config uses the exact shape if known, else the closest one,
+    // else the defaults above.
+    static void setGemmConfig(int m, int n, int k, const GemmConfig &config);
+    static GemmConfig gemmConfigFor(int m, int n, int k);
+
+    // Intra-op parallelism
+    // Kernels split their result (rows, or tiles for multiply) over the shared ThreadPool,
+    // but only into pieces of at least this many operations (multiply-adds for multiply,
+    // elements for the rest). Anything smaller, like the XOR network, never leaves
+    // the calling thread.
+    static void setParallelGrain(long operations);
+    static long getParallelGrain();
 };
 
 #endif // MATRIX_H
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "matrixStorage.h"
+#include "threadPool.h"
+#include <sys/mman.h> // For mmap, munmap, madvise
+#include <cstdlib>    // For aligned_alloc, free
+#include <cstring>    // For memset, memcpy
+#include <algorithm>  // For std::max, std::min, std::swap
+#include <atomic>
+#include <mutex>
+#include <iostream>
+
+static const size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+static std::mutex policy_lock;
+static StoragePolicy default_policy;
+
+void MatrixStorage::setDefaultPolicy(const StoragePolicy &policy) {
+    std::lock_guard<std::mutex> guard(policy_lock);
+    default_policy = policy;
+}
+
+StoragePolicy MatrixStorage::defaultPolicy() {
+    std::lock_guard<std::mutex> guard(policy_lock);
+    return default_policy;
+}
+
+static size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// First Touch
+// Zero `bytes` at dst, or copy them from src. Big buffers are split over the shared
+// pool so the page faults and the fill are shared by the pool threads.
+// numa_first_touch : pinned workers, slice w of the buffer written by worker w only
+static void touch(char *dst, const char *src, size_t bytes, const StoragePolicy &policy) {
+    auto body = [&](long begin, long end) {
+        if (src) std::memcpy(dst + begin, src + begin, end - begin);
+        else std::memset(dst + begin, 0, end - begin);
+    };
+    bool parallel = policy.parallel_first_touch || policy.numa_first_touch;
+    if (!parallel || bytes < policy.huge_page_threshold) {
+        body(0, (long)bytes);
+        return;
+    }
+    // Pieces of whole 2 MB blocks, so no page is shared by two threads
+    long blocks = (long)((bytes + HUGE_PAGE - 1) / HUGE_PAGE);
+    auto blockBody = [&](long first, long last) {
+        body(first * (long)HUGE_PAGE, std::min((long)bytes, last * (long)HUGE_PAGE));
+    };
+    ThreadPool &pool = ThreadPool::global();
+    if (policy.numa_first_touch && pool.pinWorkers()) {
+        pool.forEachWorker(blocks, blockBody);
+    } else {
+        pool.parallelFor(blocks, 1, blockBody);
+    }
+}
+
+void MatrixStorage::allocate(size_t size) {
+    data_ = nullptr;
+    size_ = size;
+    bytes_ = 0;
+    mapped_ = false;
+    if (size == 0) return;
+
+    size_t alignment = policy_.alignment;
+    if (alignment < alignof(double) || (alignment & (alignment - 1)) != 0) {
+        alignment = 64; // Not a power of two : use a cache line
+    }
+    size_t bytes = roundUp(size * sizeof(double), alignment);
+    bool big = policy_.huge_pages != HugePages::Off && bytes >= policy_.huge_page_threshold;
+
+    // 1. Explicit huge pages from the reserved pool
+#ifdef MAP_HUGETLB
+    if (big && policy_.huge_pages == HugePages::Explicit) {
+        size_t length = roundUp(bytes, HUGE_PAGE);
+        void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            data_ = static_cast<double *>(p);
+            bytes_ = length;
+            mapped_ = true;
+        } else {
+            static std::atomic<bool> warned(false);
+            if (!warned.exchange(true)) {
+                std::cerr << "[STORAGE] No reserved huge pages (vm.nr_hugepages), using transparent ones." << std::endl;
+            }
+        }
+    }
+#endif
+
+    // 2. Transparent huge pages : 2 MB aligned so whole huge pages fit, then ask for them
+    if (!data_ && big) {
+        size_t length = roundUp(bytes, HUGE_PAGE);
+        data_ = static_cast<double *>(std::aligned_alloc(HUGE_PAGE, length));
+        if (data_) {
+            bytes_ = length;
+#ifdef MADV_HUGEPAGE
+            madvise(data_, length, MADV_HUGEPAGE); // Only a hint : failure just means small pages
+#endif
+        }
+    }
+
+    // 3. Plain aligned memory
+    if (!data_) {
+        data_ = static_cast<double *>(std::aligned_alloc(alignment, bytes));
+        bytes_ = bytes;
+    }
+
+    if (!data_) {
+        std::cerr << "[STORAGE] Could not allocate " << bytes << " bytes." << std::endl;
+        size_ = 0;
+        bytes_ = 0;
+    }
+}
+
+void MatrixStorage::release() {
+    if (!data_) return;
+    if (mapped_) munmap(data_, bytes_);
+    else std::free(data_);
+    data_ = nullptr;
+}
+
+MatrixStorage::MatrixStorage() : data_(nullptr), size_(0), bytes_(0), mapped_(false) {}
+
+MatrixStorage::MatrixStorage(size_t size) : MatrixStorage(size, defaultPolicy()) {}
+
+MatrixStorage::MatrixStorage(size_t size, const StoragePolicy &policy) : policy_(policy) {
+    allocate(size);
+    if (data_) touch(reinterpret_cast<char *>(data_), nullptr, bytes_, policy_);
+}
+
+MatrixStorage::MatrixStorage(const MatrixStorage &other) : policy_(other.policy_) {
+    allocate(other.size_);
+    if (!data_) return;
+    size_t used = size_ * sizeof(double);
+    touch(reinterpret_cast<char *>(data_), reinterpret_cast<const char *>(other.data_), used, policy_);
+    std::memset(reinterpret_cast<char *>(data_) + used, 0, bytes_ - used); // Padding stays zero
+}
+
+MatrixStorage::MatrixStorage(MatrixStorage &&other) noexcept
+    : data_(other.data_), size_(other.size_), bytes_(other.bytes_), mapped_(other.mapped_), policy_(other.policy_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.bytes_ = 0;
+}
+
+// Copy-and-swap : `other` is already a copy (or a moved-from temporary)
+MatrixStorage &MatrixStorage::operator=(MatrixStorage other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(bytes_, other.bytes_);
+    std::swap(mapped_, other.mapped_);
+    std::swap(policy_, other.policy_);
+    return *this;
+}
+
+MatrixStorage::~MatrixStorage() {
+    release();
+}
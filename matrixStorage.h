@@ -0,0 +1,84 @@
+#ifndef MATRIX_STORAGE_H
+#define MATRIX_STORAGE_H
+
+#include <cstddef>
+
+/*
+    The Problem : std::vector<double> decides where our numbers live, and decides badly.
+    1. Alignment : new[] only promises 16 bytes. A 32 / 64 byte SIMD load that starts
+       in the middle of a cache line touches TWO lines ("split load").
+    2. Page size : memory is mapped in 4 KB pages, and the CPU can only remember the
+       address of a few thousand of them (the TLB). A 400 MB dataset is 100,000 pages,
+       so a pass over it keeps missing the TLB. A 2 MB "huge page" covers 512x more.
+    3. First touch : a fresh page only really exists once it is first written, and
+       vector zeroes (or copies) everything on the thread that built it. For a big
+       matrix that is one core faulting in and filling every page while the others wait.
+
+    The Fix : MatrixStorage, a fixed-size array of doubles with a StoragePolicy
+    - Start of the buffer aligned to 64 bytes (one cache line)
+    - Big buffers (>= huge_page_threshold) can ask for huge pages :
+        Transparent : 2 MB aligned + madvise(MADV_HUGEPAGE), the kernel uses huge
+                      pages when it can (no setup needed)
+        Explicit    : mmap(MAP_HUGETLB) from the reserved pool (/proc/sys/vm/nr_hugepages),
+                      falls back to Transparent when none are reserved
+    - Big buffers are zeroed / copied (first touched) in 2 MB blocks spread over the
+      shared ThreadPool, so the page faults and the fill run on several cores at once.
+      By default that says nothing about NUMA : the pool threads are not pinned and
+      work stealing hands blocks out in any order.
+    - numa_first_touch (opt-in, Linux) : the pool workers are pinned to CPUs and the
+      buffer is cut into one contiguous slice per worker, slice w touched BY worker w,
+      so it lives on worker w's node. The pinned pool then hands the row kernels
+      (forRowBlocks, multiply's tiles) the same slices : rows [w/n, (w+1)/n) of a matrix
+      go to worker w first. Work stealing can still move a piece to another worker to
+      even out the load, so most (not all) of the kernel traffic stays on its node.
+      Without pinning support it falls back to the plain parallel first touch.
+
+    Matrix uses the default policy (setDefaultPolicy) unless it is given its own.
+*/
+
+enum class HugePages {
+    Off,         // Normal 4 KB pages
+    Transparent, // madvise(MADV_HUGEPAGE) : kernel's choice, no setup
+    Explicit     // MAP_HUGETLB : reserved huge pages (fallback : Transparent)
+};
+
+struct StoragePolicy {
+    size_t alignment = 64;                       // Bytes, power of two
+    HugePages huge_pages = HugePages::Transparent;
+    size_t huge_page_threshold = 2 * 1024 * 1024; // Smaller buffers never use huge pages
+    bool parallel_first_touch = true;            // Zero big buffers from the pool threads
+    bool numa_first_touch = false;               // ... pinned, one slice per worker (pins the global pool)
+};
+
+class MatrixStorage {
+private:
+    double *data_;
+    size_t size_;      // Doubles
+    size_t bytes_;     // Actually allocated (rounded up)
+    bool mapped_;      // true : mmap (free with munmap), false : aligned_alloc (free with free)
+    StoragePolicy policy_;
+
+    void allocate(size_t size);
+    void release();
+
+public:
+    MatrixStorage();
+    explicit MatrixStorage(size_t size); // All zeros, default policy
+    MatrixStorage(size_t size, const StoragePolicy &policy);
+    MatrixStorage(const MatrixStorage &other);
+    MatrixStorage(MatrixStorage &&other) noexcept;
+    MatrixStorage &operator=(MatrixStorage other) noexcept;
+    ~MatrixStorage();
+
+    double *data() { return data_; }
+    const double *data() const { return data_; }
+    size_t size() const { return size_; }
+    double &operator[](size_t i) { return data_[i]; }
+    const double &operator[](size_t i) const { return data_[i]; }
+
+    // Policy for storage made without one (Matrix, InferenceModel buffers ...)
+    static void setDefaultPolicy(const StoragePolicy &policy);
+    static StoragePolicy defaultPolicy();
+};
+
+#endif // MATRIX_STORAGE_H
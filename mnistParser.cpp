@@ -131,4 +131,86 @@ namespace MNISTParser
         return labels;
     }
 
-}
\ No newline at end of file
+    // Load label indices
+    std::vector<int> loadLabelIndices(std::string filename)
+    {
+        std::vector<int> labels;
+
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cerr << "[ERROR] Cannot open file: " << filename << std::endl;
+            return labels;
+        }
+
+        int magic_number = readInt(file);
+        int number_of_labels = readInt(file);
+        if (magic_number != 2049)
+        {
+            std::cerr << "[ERROR] Invalid Label File! Magic Number: " << magic_number << std::endl;
+            return labels;
+        }
+
+        std::cout << "[PARSER] Loading " << number_of_labels << " label indices..." << std::endl;
+
+        // The whole body in one read, then widen each byte to an int
+        std::vector<unsigned char> bytes(number_of_labels);
+        file.read((char *)bytes.data(), number_of_labels);
+        if (file.gcount() != number_of_labels)
+        {
+            std::cerr << "[ERROR] Label file is shorter than its header says." << std::endl;
+            return labels;
+        }
+        labels.assign(bytes.begin(), bytes.end());
+
+        std::cout << "[PARSER] Labels Loaded Successfully." << std::endl;
+        return labels;
+    }
+
+
+    // Load raw images
+    std::vector<unsigned char> loadImagesRaw(std::string filename, int &rows, int &cols)
+    {
+        std::vector<unsigned char> pixels;
+        rows = 0;
+        cols = 0;
+
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cerr << "[ERROR] Cannot open file: " << filename << std::endl;
+            return pixels;
+        }
+
+        // Same 16 byte header as loadImages
+        int magic_number = readInt(file);
+        int number_of_images = readInt(file);
+        int r = readInt(file);
+        int c = readInt(file);
+
+        if (magic_number != 2051)
+        {
+            std::cerr << "[ERROR] Invalid Image File! Magic Number: " << magic_number << std::endl;
+            return pixels;
+        }
+
+        std::cout << "[PARSER] Loading " << number_of_images << " raw images..." << std::endl;
+
+        // Pixels are single bytes, no flipping or normalizing needed
+        // so the whole body can be read in one go
+        pixels.resize((size_t)number_of_images * r * c);
+        file.read((char *)pixels.data(), pixels.size());
+        if (file.gcount() != (std::streamsize)pixels.size())
+        {
+            std::cerr << "[ERROR] Image file is truncated: " << filename << std::endl;
+            pixels.clear();
+            return pixels;
+        }
+
+        rows = r;
+        cols = c;
+        std::cout << "[PARSER] Raw Images Loaded Successfully." << std::endl;
+        return pixels;
+    }
+
+}
@@ -113,6 +113,23 @@ namespace MNISTParser {
 
     std::vector<std::vector<double>> loadLabels(std::string filename);
 
+    // Load label indices
+    // Same file as loadLabels, but each label stays the plain digit (eg. 5)
+    // 4 bytes per label instead of a 10 double one-hot vector, and what
+    // NeuralNetwork::train(input, label) and the softmax head want
+    // Output : Vector of labels (each an integer 0-9)
+
+    std::vector<int> loadLabelIndices(std::string filename);
+
+    // Load raw images
+    // input: path to the MNIST image file
+    // Process : same header handling as loadImages, but pixels stay as raw bytes (0-255)
+    // Output : One flat buffer of count * rows * cols bytes (image i starts at i * rows * cols)
+    // rows / cols are written to the out parameters
+    // 8x smaller than the normalized doubles, used by the augmentation workers
+
+    std::vector<unsigned char> loadImagesRaw(std::string filename, int &rows, int &cols);
+
 
 } // namespace MNISTParser
 
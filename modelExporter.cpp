@@ -0,0 +1,149 @@
+#include "modelExporter.h"
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cctype>    // For isalpha, isalnum, toupper
+#include <cmath>     // For isfinite
+#include <algorithm> // For std::max
+
+namespace ModelExporter {
+
+    static bool isIdentifier(const std::string &name) {
+        if (name.empty() || !(std::isalpha((unsigned char)name[0]) || name[0] == '_')) return false;
+        for (char c : name) {
+            if (!(std::isalnum((unsigned char)c) || c == '_')) return false;
+        }
+        return true;
+    }
+
+    // One weight matrix as a 2D constexpr array (cols = 0 : a 1D bias list), one row per line
+    // Hex floats (eg. 0x1.8p-1) hold the exact bits of a double in text
+    static void writeArray(std::ostream &out, const char *name, const double *values, int rows, int cols) {
+        bool matrix = cols > 0;
+        cols = std::max(cols, 1);
+        out << "    alignas(64) constexpr double " << name << "[" << rows << "]";
+        if (matrix) out << "[" << cols << "]";
+        out << " = {\n";
+        for (int i = 0; i < rows; i++) {
+            out << "        ";
+            if (matrix) out << "{";
+            for (int j = 0; j < cols; j++) {
+                out << values[i * cols + j];
+                if (j + 1 < cols) out << ", ";
+            }
+            if (matrix) out << "}";
+            out << (i + 1 < rows ? ",\n" : "\n");
+        }
+        out << "    };\n\n";
+    }
+
+    std::string generateHeader(const NeuralNetwork &nn, const std::string &name) {
+        if (!isIdentifier(name)) {
+            std::cerr << "[EXPORT] Not a valid C++ name: " << name << std::endl;
+            return std::string();
+        }
+        int inputs = nn.getInputNodes();
+        int hidden = nn.getHiddenNodes();
+        int outputs = nn.getOutputNodes();
+        bool softmax = nn.getOutputHead() == OutputHead::SoftmaxCrossEntropy;
+
+        // Flat parameter layout : [ weights_ho | bias_o | weights_ih | bias_h ]
+        std::vector<double> params(nn.parameterCount());
+        nn.copyParametersTo(params.data());
+        const double *w_ho = params.data();
+        const double *b_o = w_ho + outputs * hidden;
+        const double *w_ih = b_o + outputs;
+        const double *b_h = w_ih + hidden * inputs;
+        for (double v : params) {
+            if (!std::isfinite(v)) {
+                std::cerr << "[EXPORT] Network has NaN / infinite weights, not exporting." << std::endl;
+                return std::string();
+            }
+        }
+
+        std::string guard;
+        for (char c : name) guard += (char)std::toupper((unsigned char)c);
+        guard += "_MODEL_H";
+
+        std::ostringstream out;
+        out << std::hexfloat;
+        out << "// Generated by ModelExporter from a " << inputs << "-" << hidden << "-" << outputs
+            << (softmax ? " softmax" : "") << " NeuralNetwork. Do not edit.\n"
+            << "// Same outputs as NeuralNetwork::feedForward (build without -ffast-math / -ffp-contract=fast).\n"
+            << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+            << "#include <cmath>\n\n"
+            << "namespace " << name << " {\n\n"
+            << "    constexpr int INPUT_NODES = " << inputs << ";\n"
+            << "    constexpr int HIDDEN_NODES = " << hidden << ";\n"
+            << "    constexpr int OUTPUT_NODES = " << outputs << ";\n\n";
+
+        writeArray(out, "WEIGHTS_IH", w_ih, hidden, inputs);
+        writeArray(out, "BIAS_H", b_h, hidden, 0);
+        writeArray(out, "WEIGHTS_HO", w_ho, outputs, hidden);
+        writeArray(out, "BIAS_O", b_o, outputs, 0);
+
+        // The inference function : loop bounds are constants, the hidden layer is on the stack
+        out << "    inline double sigmoid(double x) {\n"
+            << "        return 1.0 / (1.0 + std::exp(-x));\n"
+            << "    }\n\n"
+            << "    // input : INPUT_NODES values, output : OUTPUT_NODES values\n"
+            << "    inline void predict(const double *input, double *output) {\n"
+            << "        double hidden[HIDDEN_NODES];\n"
+            << "        for (int i = 0; i < HIDDEN_NODES; i++) {\n"
+            << "            double sum = 0.0;\n"
+            << "            for (int k = 0; k < INPUT_NODES; k++) sum += WEIGHTS_IH[i][k] * input[k];\n"
+            << "            hidden[i] = sigmoid(sum + BIAS_H[i]);\n"
+            << "        }\n"
+            << "        for (int i = 0; i < OUTPUT_NODES; i++) {\n"
+            << "            double sum = 0.0;\n"
+            << "            for (int k = 0; k < HIDDEN_NODES; k++) sum += WEIGHTS_HO[i][k] * hidden[k];\n";
+        if (softmax) {
+            // Same steps, same order as Softmax::probabilities
+            out << "            output[i] = sum + BIAS_O[i];\n"
+                << "        }\n"
+                << "        // Softmax : subtract the biggest logit, exp, divide by the total\n"
+                << "        double max_logit = output[0];\n"
+                << "        for (int i = 1; i < OUTPUT_NODES; i++) {\n"
+                << "            if (output[i] > max_logit) max_logit = output[i];\n"
+                << "        }\n"
+                << "        double total = 0.0;\n"
+                << "        for (int i = 0; i < OUTPUT_NODES; i++) {\n"
+                << "            output[i] = std::exp(output[i] - max_logit);\n"
+                << "            total += output[i];\n"
+                << "        }\n"
+                << "        double inv = 1.0 / total;\n"
+                << "        for (int i = 0; i < OUTPUT_NODES; i++) output[i] *= inv;\n";
+        } else {
+            out << "            output[i] = sigmoid(sum + BIAS_O[i]);\n"
+                << "        }\n";
+        }
+        out << "    }\n\n"
+            << "    // Array version : sizes are checked by the compiler\n"
+            << "    inline void predict(const double (&input)[INPUT_NODES], double (&output)[OUTPUT_NODES]) {\n"
+            << "        predict(&input[0], &output[0]);\n"
+            << "    }\n\n"
+            << "} // namespace " << name << "\n\n"
+            << "#endif // " << guard << "\n";
+        return out.str();
+    }
+
+    bool exportHeader(const NeuralNetwork &nn, const std::string &path, const std::string &name) {
+        std::string text = generateHeader(nn, name);
+        if (text.empty()) return false;
+
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "[EXPORT] Cannot write: " << path << std::endl;
+            return false;
+        }
+        file << text;
+        file.close();
+        if (!file.good()) {
+            std::cerr << "[EXPORT] Write failed: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace ModelExporter
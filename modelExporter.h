@@ -0,0 +1,42 @@
+#ifndef MODEL_EXPORTER_H
+#define MODEL_EXPORTER_H
+
+#include <string>
+#include "neuralNetwork.h"
+
+/*
+    The Problem : Loading a model costs time, memory and code.
+    On a small device we would need the file, a parser, the Matrix engine and a heap
+    just to get weights we already knew when the firmware was built.
+
+    The Fix : Compile the model INTO the program.
+    The exporter writes a plain C++ header for one trained network:
+    - Every weight as an `alignas(64) constexpr double` array (exact bits, printed
+      as hex floats so nothing is lost going through text)
+    - A predict() written for exactly this topology : all sizes are compile-time
+      constants, so the compiler unrolls / vectorizes the loops for this shape
+    - Only <cmath> is needed. No Matrix, no heap, no file, nothing to load :
+      the weights sit in read-only memory from the moment the program starts
+
+        #include "xorModel.h"
+        double out[xorModel::OUTPUT_NODES];
+        xorModel::predict(in, out);
+
+    predict() adds its terms in the same order as NeuralNetwork::feedForward
+    (0, then k = 0, 1, 2 ..., then the bias), so it gives the same outputs as long
+    as the compiler is not told to reorder or fuse floating point math
+    (eg. -ffast-math, or -ffp-contract=fast on CPUs with FMA).
+*/
+
+namespace ModelExporter {
+
+    // Header text for the network, everything inside `namespace name`
+    // (name must be a valid C++ identifier, it also builds the include guard)
+    std::string generateHeader(const NeuralNetwork &nn, const std::string &name);
+
+    // Write generateHeader(nn, name) to path. Returns false (and prints why) on failure.
+    bool exportHeader(const NeuralNetwork &nn, const std::string &path, const std::string &name);
+
+} // namespace ModelExporter
+
+#endif // MODEL_EXPORTER_H
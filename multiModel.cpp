@@ -0,0 +1,277 @@
+#include "multiModel.h"
+#include "threadPool.h"
+#include "softmax.h"
+#include <algorithm> // For std::min, std::max_element
+#include <iostream>
+
+// The constructor
+// Goal : copy K separate networks into the stacked layout
+MultiModelTrainer::MultiModelTrainer(const std::vector<NeuralNetwork> &networks)
+    : models((int)networks.size()),
+      input_nodes(networks.empty() ? 0 : networks[0].getInputNodes()),
+      hidden_nodes(networks.empty() ? 0 : networks[0].getHiddenNodes()),
+      output_nodes(networks.empty() ? 0 : networks[0].getOutputNodes()),
+      output_head(networks.empty() ? OutputHead::Sigmoid : networks[0].getOutputHead()),
+      weights_ih(models * hidden_nodes, input_nodes),
+      bias_h(models * hidden_nodes, 1),
+      weights_ho(models * output_nodes, hidden_nodes),
+      bias_o(models * output_nodes, 1)
+{
+    for (const NeuralNetwork &nn : networks) {
+        if (nn.getInputNodes() != input_nodes || nn.getHiddenNodes() != hidden_nodes
+            || nn.getOutputNodes() != output_nodes || nn.getOutputHead() != output_head) {
+            std::cerr << "Error : All packed models must have the same topology." << std::endl;
+            models = 0;
+            return;
+        }
+    }
+
+    // Flat parameter layout of a NeuralNetwork : [ weights_ho | bias_o | weights_ih | bias_h ]
+    std::vector<double> params(networks.empty() ? 0 : networks[0].parameterCount());
+    for (int k = 0; k < models; k++) {
+        networks[k].copyParametersTo(params.data());
+        const double *p = params.data();
+        ConstMatrixView src_ho(p, output_nodes, hidden_nodes);
+        p += output_nodes * hidden_nodes;
+        ConstMatrixView src_bo(p, output_nodes, 1);
+        p += output_nodes;
+        ConstMatrixView src_ih(p, hidden_nodes, input_nodes);
+        p += hidden_nodes * input_nodes;
+        ConstMatrixView src_bh(p, hidden_nodes, 1);
+
+        // Copy = add onto the zero-initialized block
+        Matrix::add(block(weights_ho.view(), k, output_nodes), src_ho, block(weights_ho.view(), k, output_nodes));
+        Matrix::add(block(bias_o.view(), k, output_nodes), src_bo, block(bias_o.view(), k, output_nodes));
+        Matrix::add(block(weights_ih.view(), k, hidden_nodes), src_ih, block(weights_ih.view(), k, hidden_nodes));
+        Matrix::add(block(bias_h.view(), k, hidden_nodes), src_bh, block(bias_h.view(), k, hidden_nodes));
+
+        learning_rates.push_back(networks[k].getLearningRate());
+    }
+}
+
+MatrixView MultiModelTrainer::block(MatrixView m, int k, int block_rows) {
+    return MatrixView(m.data + (size_t)k * block_rows * m.row_stride, block_rows, m.cols,
+                      m.row_stride, m.col_stride);
+}
+
+ConstMatrixView MultiModelTrainer::block(ConstMatrixView m, int k, int block_rows) {
+    return ConstMatrixView(m.data + (size_t)k * block_rows * m.row_stride, block_rows, m.cols,
+                           m.row_stride, m.col_stride);
+}
+
+// Forward pass of all K models
+// hidden  : (K*hidden) x B, one multiply for every model at once
+// outputs : (K*output) x B, block k = model k
+void MultiModelTrainer::forward(ConstMatrixView inputs, Matrix &hidden, Matrix &outputs) const {
+    Matrix::multiply(weights_ih.view(), inputs, hidden.view());
+    Matrix::addColumn(hidden.view(), bias_h.view(), hidden.view());
+    Matrix::map(hidden.view(), NeuralNetwork::sigmoid, hidden.view());
+
+    for (int k = 0; k < models; k++) {
+        Matrix::multiply(block(weights_ho.view(), k, output_nodes), block(hidden.view(), k, hidden_nodes),
+                         block(outputs.view(), k, output_nodes));
+    }
+    Matrix::addColumn(outputs.view(), bias_o.view(), outputs.view());
+    // Softmax head : outputs stay logits, the fused kernel (softmax.h) takes it from there
+    if (output_head == OutputHead::Sigmoid) {
+        Matrix::map(outputs.view(), NeuralNetwork::sigmoid, outputs.view());
+    }
+}
+
+// Backward pass for models [first, last)
+/*
+    Per model, same steps as NeuralNetwork::train :
+    output error -> output gradient -> hidden error (through the OLD weights_ho)
+    -> update weights_ho / bias_o.
+    The hidden gradients (already scaled by that model's learning rate) are written
+    into the stacked hidden_gradients so trainBatch can update weights_ih of all
+    models with one multiply afterwards.
+    Models never touch each other's blocks, so ranges can run on different threads.
+*/
+void MultiModelTrainer::backwardModels(int first, int last, ConstMatrixView targets, Matrix &hidden,
+                                       Matrix &outputs, Matrix &hidden_gradients, int batch) {
+    Matrix output_errors(output_nodes, batch);
+    Matrix gradients(output_nodes, batch);
+    Matrix hidden_errors(hidden_nodes, batch);
+    Matrix deltas(output_nodes, hidden_nodes);
+
+    for (int k = first; k < last; k++) {
+        double step = learning_rates[k] / batch; // Batch average
+        MatrixView out_k = block(outputs.view(), k, output_nodes);
+        MatrixView hid_k = block(hidden.view(), k, hidden_nodes);
+        MatrixView w_ho_k = block(weights_ho.view(), k, output_nodes);
+        MatrixView b_o_k = block(bias_o.view(), k, output_nodes);
+        MatrixView hgrad_k = block(hidden_gradients.view(), k, hidden_nodes);
+
+        // ERROR = TARGETS - OUTPUTS, GRADIENT = dsigmoid(OUTPUT) * ERROR * step
+        // (softmax head : ERROR = TARGETS - softmax(LOGITS) from the fused kernel, one
+        //  call per sample column, and GRADIENT = ERROR * step)
+        if (output_head == OutputHead::SoftmaxCrossEntropy) {
+            MatrixView errors = output_errors.view();
+            for (int b = 0; b < batch; b++) {
+                Softmax::crossEntropy(&out_k.at(0, b), &targets.at(0, b), output_nodes, &errors.at(0, b),
+                                      targets.row_stride, errors.row_stride);
+            }
+            Matrix::multiplyScalar(output_errors.view(), step, gradients.view());
+        } else {
+            Matrix::subtract(targets, out_k, output_errors.view());
+            Matrix::map(out_k, NeuralNetwork::dsigmoid, gradients.view());
+            Matrix::multiplyHadamard(gradients.view(), output_errors.view(), gradients.view());
+            Matrix::multiplyScalar(gradients.view(), step, gradients.view());
+        }
+
+        // Hidden error before weights_ho changes
+        Matrix::multiply(ConstMatrixView(w_ho_k).transposed(), output_errors.view(), hidden_errors.view());
+
+        // weights_ho += gradient * hidden_T, bias_o += gradient (summed over the batch)
+        Matrix::multiply(gradients.view(), ConstMatrixView(hid_k).transposed(), deltas.view());
+        Matrix::add(w_ho_k, deltas.view(), w_ho_k);
+        for (int i = 0; i < output_nodes; i++) {
+            double sum = 0.0;
+            for (int b = 0; b < batch; b++) sum += gradients.at(i, b);
+            b_o_k.at(i, 0) += sum;
+        }
+
+        // Hidden gradient = dsigmoid(hidden) * hidden_error * step
+        Matrix::map(hid_k, NeuralNetwork::dsigmoid, hgrad_k);
+        Matrix::multiplyHadamard(hgrad_k, hidden_errors.view(), hgrad_k);
+        Matrix::multiplyScalar(hgrad_k, step, hgrad_k);
+    }
+}
+
+void MultiModelTrainer::trainBatch(ConstMatrixView inputs, ConstMatrixView targets) {
+    if (inputs.rows != input_nodes || targets.rows != output_nodes || inputs.cols != targets.cols) {
+        std::cerr << "Error : Batch shape does not match the packed models." << std::endl;
+        return;
+    }
+    int batch = inputs.cols;
+    if (models == 0 || batch == 0) return;
+
+    Matrix hidden(models * hidden_nodes, batch);
+    Matrix outputs(models * output_nodes, batch);
+    Matrix hidden_gradients(models * hidden_nodes, batch);
+    forward(inputs, hidden, outputs);
+
+    // Spread the per-model backward work over the shared pool, one piece per few models,
+    // but only when there is enough of it (tiny sweeps stay on the calling thread)
+    long work_per_model = (long)batch * hidden_nodes * (output_nodes + 1);
+    long grain = std::max(1L, Matrix::getParallelGrain() / std::max(1L, work_per_model));
+    ThreadPool::global().parallelFor(models, grain, [&](long first, long last) {
+        backwardModels((int)first, (int)last, targets, hidden, outputs, hidden_gradients, batch);
+    });
+
+    // All K input->hidden updates in ONE multiply : (K*hidden x B) * (B x input)
+    Matrix deltas(models * hidden_nodes, input_nodes);
+    Matrix::multiply(hidden_gradients.view(), inputs.transposed(), deltas.view());
+    Matrix::add(weights_ih.view(), deltas.view(), weights_ih.view());
+    for (int i = 0; i < models * hidden_nodes; i++) {
+        double sum = 0.0;
+        for (int b = 0; b < batch; b++) sum += hidden_gradients.at(i, b);
+        bias_h.at(i, 0) += sum;
+    }
+}
+
+// Pack samples [start, start + count) of a dataset into one-sample-per-column matrices
+static void packColumns(const std::vector<std::vector<double>> &rows, int start, int count, Matrix &out) {
+    for (int b = 0; b < count; b++) {
+        const std::vector<double> &sample = rows[start + b];
+        for (int i = 0; i < out.getRows(); i++) {
+            out.at(i, b) = sample[i];
+        }
+    }
+}
+
+void MultiModelTrainer::trainEpoch(const std::vector<std::vector<double>> &inputs,
+                                   const std::vector<std::vector<double>> &targets, int batch_size) {
+    if (batch_size <= 0 || inputs.size() != targets.size()) {
+        std::cerr << "Error : Bad batch size or inputs / targets size mismatch." << std::endl;
+        return;
+    }
+    int total = (int)inputs.size();
+    for (int start = 0; start < total; start += batch_size) {
+        int count = std::min(batch_size, total - start);
+        // The batch is packed ONCE and shared by all K models
+        Matrix x(input_nodes, count);
+        Matrix t(output_nodes, count);
+        packColumns(inputs, start, count, x);
+        packColumns(targets, start, count, t);
+        trainBatch(x.view(), t.view());
+    }
+}
+
+std::vector<ModelMetrics> MultiModelTrainer::evaluate(const std::vector<std::vector<double>> &inputs,
+                                                      const std::vector<std::vector<double>> &targets) const {
+    std::vector<ModelMetrics> metrics(models, ModelMetrics{0.0, 0.0});
+    bool softmax = output_head == OutputHead::SoftmaxCrossEntropy;
+    int total = (int)std::min(inputs.size(), targets.size());
+    const int chunk = 256;
+
+    for (int start = 0; start < total; start += chunk) {
+        int count = std::min(chunk, total - start);
+        Matrix x(input_nodes, count);
+        Matrix t(output_nodes, count);
+        packColumns(inputs, start, count, x);
+        packColumns(targets, start, count, t);
+
+        Matrix hidden(models * hidden_nodes, count);
+        Matrix outputs(models * output_nodes, count);
+        forward(x.view(), hidden, outputs);
+
+        Matrix errors(output_nodes, count); // Softmax head : fused kernel scratch (same layout as a block)
+        for (int k = 0; k < models; k++) {
+            ConstMatrixView out_k = block(ConstMatrixView(outputs.view()), k, output_nodes);
+            for (int b = 0; b < count; b++) {
+                int guess = 0, actual = 0;
+                if (softmax) {
+                    // Cross-entropy straight from the logits (argmax of logits = argmax of softmax)
+                    metrics[k].loss += Softmax::crossEntropy(&out_k.at(0, b), &t.at(0, b), output_nodes,
+                                                             &errors.at(0, b), t.view().row_stride,
+                                                             out_k.row_stride);
+                }
+                for (int i = 0; i < output_nodes; i++) {
+                    if (!softmax) {
+                        double diff = t.at(i, b) - out_k.at(i, b);
+                        metrics[k].loss += diff * diff / output_nodes;
+                    }
+                    if (out_k.at(i, b) > out_k.at(guess, b)) guess = i;
+                    if (t.at(i, b) > t.at(actual, b)) actual = i;
+                }
+                bool correct = output_nodes == 1
+                    ? ((out_k.at(0, b) > 0.5) == (t.at(0, b) > 0.5))
+                    : guess == actual;
+                if (correct) metrics[k].accuracy += 1.0;
+            }
+        }
+    }
+
+    for (ModelMetrics &m : metrics) {
+        m.loss /= std::max(1, total);
+        m.accuracy /= std::max(1, total);
+    }
+    return metrics;
+}
+
+void MultiModelTrainer::exportModel(int k, NeuralNetwork &nn) const {
+    if (k < 0 || k >= models || nn.getInputNodes() != input_nodes
+        || nn.getHiddenNodes() != hidden_nodes || nn.getOutputNodes() != output_nodes
+        || nn.getOutputHead() != output_head) {
+        std::cerr << "Error : Cannot export model " << k << " into this network." << std::endl;
+        return;
+    }
+
+    // Rebuild the flat layout : [ weights_ho | bias_o | weights_ih | bias_h ]
+    std::vector<double> params;
+    params.reserve(nn.parameterCount());
+    ConstMatrixView parts[4] = {
+        block(weights_ho.view(), k, output_nodes), block(bias_o.view(), k, output_nodes),
+        block(weights_ih.view(), k, hidden_nodes), block(bias_h.view(), k, hidden_nodes)};
+    for (const ConstMatrixView &part : parts) {
+        for (int i = 0; i < part.rows; i++) {
+            for (int j = 0; j < part.cols; j++) {
+                params.push_back(part.at(i, j));
+            }
+        }
+    }
+    nn.setParametersFrom(params.data());
+    nn.setLearningRate(learning_rates[k]);
+}
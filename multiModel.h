@@ -0,0 +1,86 @@
+#ifndef MULTIMODEL_H
+#define MULTIMODEL_H
+
+#include <vector>
+#include "matrix.h"
+#include "neuralNetwork.h"
+
+/*
+    The Problem : Hyperparameter sweeps
+    Training 32 copies of a 2-4-1 network (different seeds / learning rates) one
+    process at a time means 32 x tiny matrix-vector products, each far too small
+    to keep a core busy. Almost all the time goes into overhead, not math.
+
+    The Trick : Stack the K models into one big model
+    All K models see the SAME input, so their input->hidden weights can sit on
+    top of each other in one (K*hidden x input) matrix:
+
+        [ W_ih model 0 ]               [ hidden model 0 ]
+        [ W_ih model 1 ]  * inputs  =  [ hidden model 1 ]
+        [     ...      ]               [      ...       ]
+
+    One big multiply replaces K small ones. The hidden->output weights are
+    "block diagonal" (model k only sees its own hidden units), so they are stored as
+    K blocks of (output x hidden) and each block works on its own slice of the
+    stacked hidden layer through a view (no copies).
+    On the way back the same trick runs in reverse : the input->hidden weight
+    updates of all K models come out of ONE multiply of the stacked hidden
+    gradients with the shared inputs.
+
+    Every model keeps its own learning rate (from the NeuralNetwork it was built from)
+    and can be exported back into a normal NeuralNetwork at any time.
+*/
+
+// Per-model result of evaluate()
+struct ModelMetrics {
+    double loss;     // Mean squared error (over samples and outputs), cross-entropy per sample for a softmax head
+    double accuracy; // Fraction correct (argmax, or > 0.5 for a single output)
+};
+
+class MultiModelTrainer {
+private:
+    // 1. Shared Topology
+    int models;
+    int input_nodes, hidden_nodes, output_nodes;
+    OutputHead output_head; // Shared by every model
+
+    // 2. Stacked Parameters
+    Matrix weights_ih; // (K*hidden) x input   : all models on top of each other
+    Matrix bias_h;     // (K*hidden) x 1
+    Matrix weights_ho; // (K*output) x hidden  : block k = rows k*output ...
+    Matrix bias_o;     // (K*output) x 1
+    std::vector<double> learning_rates;
+
+    // Model k's slice of a stacked matrix (rows block_rows*k ... block_rows*(k+1))
+    static MatrixView block(MatrixView m, int k, int block_rows);
+    static ConstMatrixView block(ConstMatrixView m, int k, int block_rows);
+
+    // outputs : sigmoid outputs, or logits for a softmax head
+    void forward(ConstMatrixView inputs, Matrix &hidden, Matrix &outputs) const;
+    void backwardModels(int first, int last, ConstMatrixView targets, Matrix &hidden,
+                        Matrix &outputs, Matrix &hidden_gradients, int batch);
+
+public:
+    // All networks must have the same topology (and output head). Their weights are copied in.
+    MultiModelTrainer(const std::vector<NeuralNetwork> &networks);
+
+    int modelCount() const { return models; }
+
+    // One SGD step of every model on the same mini-batch
+    // inputs : input_nodes x B, targets : output_nodes x B (one sample per column)
+    // A B = 1 step is the same update NeuralNetwork::train makes.
+    void trainBatch(ConstMatrixView inputs, ConstMatrixView targets);
+
+    // One pass over a dataset with mini-batches of batch_size (dataset is only read)
+    void trainEpoch(const std::vector<std::vector<double>> &inputs,
+                    const std::vector<std::vector<double>> &targets, int batch_size);
+
+    // Loss / accuracy of every model on a dataset
+    std::vector<ModelMetrics> evaluate(const std::vector<std::vector<double>> &inputs,
+                                       const std::vector<std::vector<double>> &targets) const;
+
+    // Copy model k's current weights back into a normal network (same topology)
+    void exportModel(int k, NeuralNetwork &nn) const;
+};
+
+#endif // MULTIMODEL_H
@@ -1,15 +1,19 @@
 #include "neuralNetwork.h"
 #include "matrix.h"
+#include "inferenceModel.h"
+#include "softmax.h"
 #include <vector>
 #include <cmath> // For exp function
+#include <algorithm> // For std::fill
 
 // The constructor 
 // Goal to set up topology and resize all matrices
 
-NeuralNetwork::NeuralNetwork(int input_nodes, int hidden_nodes, int output_nodes)
+NeuralNetwork::NeuralNetwork(int input_nodes, int hidden_nodes, int output_nodes, OutputHead output_head)
     :input_nodes(input_nodes),
     hidden_nodes(hidden_nodes),
     output_nodes(output_nodes),
+    output_head(output_head),
     // Initialize matrices with specific dimensions
     weights_ih(hidden_nodes, input_nodes),
     weights_ho(output_nodes, hidden_nodes),
@@ -68,6 +72,18 @@ double NeuralNetwork::dsigmoid(double y){
     return y * (1 - y);
 }
 
+// Output Activation
+// Sigmoid head : each output on its own. Softmax head : each column (one sample) together.
+void NeuralNetwork::activateOutputs(MatrixView outputs) const {
+    if (output_head == OutputHead::Sigmoid) {
+        Matrix::map(outputs, sigmoid, outputs);
+        return;
+    }
+    for (int b = 0; b < outputs.cols; b++) {
+        Softmax::probabilities(&outputs.at(0, b), outputs.rows, outputs.row_stride);
+    }
+}
+
 
 
 // Feedforward function
@@ -82,84 +98,138 @@ double NeuralNetwork::dsigmoid(double y){
     4. Convert output Matrix back to C++ vector and return it
 */
 
-std::vector<double> NeuralNetwork::feedForward(std::vector<double> input_array){
+std::vector<double> NeuralNetwork::feedForward(const std::vector<double> &input_array){
     // 1. Vector to Matrix
     // We need tu turn list (eg [0.5, 0.2, 0.1]) into a column matrix
     // So our math engine can process it
+    // A view does this without copying : it just points at the vector's memory
     if (input_array.size() != input_nodes){
         std::cerr << "Error: Input size does not match number of input nodes." << std::endl;
         return std::vector<double>(); // Return empty vector on error
     }
 
-    // Create matrix from the vector data manually
-    Matrix inputs(input_nodes, 1);
-    for(int i = 0 ; i < input_nodes; i++){
-        inputs.at(i, 0) = input_array[i];
+    // 5. Matrix to Vector
+    // The output layer writes straight into the result vector
+    std::vector<double> result(output_nodes);
+    feedForward(ConstMatrixView::column(input_array), MatrixView::column(result.data(), output_nodes));
+    return result;
+}
+
+bool NeuralNetwork::feedForward(ConstMatrixView inputs, MatrixView outputs){
+    if (inputs.rows != input_nodes || outputs.rows != output_nodes || outputs.cols != inputs.cols){
+        std::cerr << "Error: Input / Output view size does not match the network." << std::endl;
+        return false;
     }
+    int batch = inputs.cols; // One sample per column
 
     // 2. HIDDEN LAYER
-    Matrix hidden = weights_ih.multiply(inputs); // Weighted sum
-    hidden = hidden.add(bias_h); // Add bias
+    Matrix hidden(hidden_nodes, batch);
+    Matrix::multiply(weights_ih.view(), inputs, hidden.view()); // Weighted sum
+    Matrix::addColumn(hidden.view(), bias_h.view(), hidden.view()); // Add bias
 
     // 3. Apply activation function to hidden layer
-    hidden = hidden.map(sigmoid); // map function applies sigmoid to each element
+    Matrix::map(hidden.view(), sigmoid, hidden.view()); // map function applies sigmoid to each element
 
-    // 4. OUTPUT LAYER
-    Matrix outputs = weights_ho.multiply(hidden); // Weighted sum
-    outputs = outputs.add(bias_o); // Add bias
-    outputs = outputs.map(sigmoid); // Apply activation function
+    // 4. OUTPUT LAYER (written directly into the caller's memory)
+    Matrix::multiply(weights_ho.view(), hidden.view(), outputs); // Weighted sum
+    Matrix::addColumn(outputs, bias_o.view(), outputs); // Add bias
+    activateOutputs(outputs); // Apply activation function (sigmoid or softmax)
+    return true;
+}
 
-    // 5. Matrix to Vector
-    std::vector<double> result;
-    for(int i=0; i<output_nodes;i++){
-        result.push_back(outputs.at(i,0));
+void NeuralNetwork::train(const std::vector<double> &input_array, const std::vector<double> &target_array) {
+    if (input_array.size() != input_nodes || target_array.size() != output_nodes) {
+        std::cerr << "Input or Target size mismatch!" << std::endl;
+        return;
     }
-    return result;
+    // No conversion needed, the views point straight at the vectors
+    train(ConstMatrixView::column(input_array), ConstMatrixView::column(target_array));
+}
+
+void NeuralNetwork::train(ConstMatrixView inputs, ConstMatrixView targets) {
+    train(inputs, targets, MatrixView(nullptr, 0, 0)); // Nobody below us wants the input errors
+}
+
+void NeuralNetwork::train(ConstMatrixView inputs, ConstMatrixView targets, MatrixView input_errors) {
+    if (targets.rows != output_nodes || targets.cols != 1) {
+        std::cerr << "Input or Target size mismatch!" << std::endl;
+        return;
+    }
+    backpropagate(inputs, targets, -1, input_errors);
+}
+
+double NeuralNetwork::train(const std::vector<double> &input_array, int label) {
+    if (input_array.size() != input_nodes) {
+        std::cerr << "Input or Target size mismatch!" << std::endl;
+        return 0.0;
+    }
+    return train(ConstMatrixView::column(input_array), label);
 }
 
-void NeuralNetwork::train(std::vector<double> input_array, std::vector<double> target_array) {
+double NeuralNetwork::train(ConstMatrixView inputs, int label) {
+    if (label < 0 || label >= output_nodes) {
+        std::cerr << "Error: Label " << label << " is not one of the " << output_nodes << " outputs." << std::endl;
+        return 0.0;
+    }
+    return backpropagate(inputs, ConstMatrixView(nullptr, 0, 0), label, MatrixView(nullptr, 0, 0));
+}
+
+double NeuralNetwork::backpropagate(ConstMatrixView inputs, ConstMatrixView targets, int label, MatrixView input_errors) {
     
     // PHASE 1: FEED FORWARD :  AI Takes a Guess
     // Goal: Pass data from Input -> Hidden -> Output to get the current prediction.  
-    //   Convert Inputs to Matrix
-    if (input_array.size() != input_nodes || target_array.size() != output_nodes) {
+    if (inputs.rows != input_nodes || inputs.cols != 1) {
         std::cerr << "Input or Target size mismatch!" << std::endl;
-        return;
+        return 0.0;
     }
-    // Preparing the input matrix
-    // Convert Inputs to Matrix  
-    Matrix inputs(input_nodes, 1);
-    for (int i = 0; i < input_nodes; i++) {
-        inputs.at(i, 0) = input_array[i];
+    if (input_errors.data && (input_errors.rows != input_nodes || input_errors.cols != 1)) {
+        std::cerr << "Input error size mismatch!" << std::endl;
+        return 0.0;
     }
     
     //   Calculate Hidden Layer Output
     // Inputs -> Hidden
     // Math : hidden = sigmoid(weights_ih * inputs + bias_h)
-    Matrix hidden = weights_ih.multiply(inputs); // Weighted sum // dot product
-    hidden = hidden.add(bias_h); // Add bias
-    hidden = hidden.map(sigmoid); // Activation : Squishes to 0-1
+    Matrix hidden(hidden_nodes, 1);
+    Matrix::multiply(weights_ih.view(), inputs, hidden.view()); // Weighted sum // dot product
+    Matrix::add(hidden.view(), bias_h.view(), hidden.view()); // Add bias
+    Matrix::map(hidden.view(), sigmoid, hidden.view()); // Activation : Squishes to 0-1
    
     
     //   Calculate Final Output
     // Hidden -> Output
     // Math : outputs = sigmoid(weights_ho * hidden + bias_o)
-    Matrix outputs = weights_ho.multiply(hidden); // Weighted sum
-    outputs = outputs.add(bias_o); // Add bias
-    outputs = outputs.map(sigmoid); // Activation
+    // (softmax head : stop at the weighted sums, the fused kernel below does the rest)
+    Matrix outputs(output_nodes, 1);
+    Matrix::multiply(weights_ho.view(), hidden.view(), outputs.view()); // Weighted sum
+    Matrix::add(outputs.view(), bias_o.view(), outputs.view()); // Add bias
+    bool softmax = output_head == OutputHead::SoftmaxCrossEntropy;
+    if (!softmax) {
+        Matrix::map(outputs.view(), sigmoid, outputs.view()); // Activation
+    }
     
     // PHASE 2: BACKPROPAGATION (Who responsible for the error?)
     // Goal: Calculate errors and check how much each weight contributed to the error.
     
-    // target vector to target Matrix
-    Matrix target(output_nodes, 1);
-    for(int i = 0; i < output_nodes; i++) {
-        target.at(i, 0) = target_array[i];
-    }
     //   Calculate Output Error
     // ERROR = TARGETS - OUTPUTS
     // Example: Wanted 1.0, got 0.2. Error = 0.8 (We need to go UP).
-    Matrix output_errors = target.subtract(outputs);
+    // Softmax head : softmax, loss and error in one fused kernel over the logits (softmax.h)
+    Matrix output_errors(output_nodes, 1);
+    double *errors = output_errors.view().data;
+    const double *out = outputs.view().data;
+    double loss = 0.0;
+    if (softmax) {
+        loss = label >= 0 ? Softmax::crossEntropy(out, label, output_nodes, errors)
+                          : Softmax::crossEntropy(out, &targets.at(0, 0), output_nodes, errors, targets.row_stride);
+    } else {
+        if (label >= 0) {
+            for (int i = 0; i < output_nodes; i++) errors[i] = (i == label ? 1.0 : 0.0) - out[i];
+        } else {
+            Matrix::subtract(targets, outputs.view(), output_errors.view());
+        }
+        for (int i = 0; i < output_nodes; i++) loss += errors[i] * errors[i];
+    }
 
     //   Calculate Hidden Error
     // ERROR_HIDDEN = WEIGHTS_HO_TRANSPOSED * ERROR_OUTPUT
@@ -170,8 +240,9 @@ void NeuralNetwork::train(std::vector<double> input_array, std::vector<double> t
     // Why transpose?
     // Forward : Hidden(2 x 1) -> Weights_ho(1 x 2) -> Output(1 x 1)
     // Backward : Output_Error(1 x 1) -> Hidden_Error(2 x 1) needs Weights(2 x 1)
-    Matrix weights_ho_T = weights_ho.transpose();
-    Matrix hidden_errors = weights_ho_T.multiply(output_errors);
+    // The transposed view just reads weights_ho with swapped strides, no copy
+    Matrix hidden_errors(hidden_nodes, 1);
+    Matrix::multiply(weights_ho.view().transposed(), output_errors.view(), hidden_errors.view());
 
     // PHASE 3: GRADIENT DESCENT (Update the Weights)
     // Goal : Nudge the waits to reduce error next time.
@@ -183,31 +254,224 @@ void NeuralNetwork::train(std::vector<double> input_array, std::vector<double> t
     // Logic:
     // if output was close to 0 or 1, dsigmoid is small -> small change(dont change much)
     // if output was around 0.5, dsigmoid is large -> large change (change more)
-     Matrix gradients = outputs.map(dsigmoid); // Derivative of outputs (calculating slope)
-    gradients = gradients.multiplyHadamard(output_errors); // Element-wise multiplication
-    gradients = gradients.multiplyScalar(learning_rate); 
+    // Softmax head : the error already IS the gradient (no dsigmoid), Gradient = Error * LearningRate
+    Matrix gradients(output_nodes, 1);
+    if (softmax) {
+        Matrix::multiplyScalar(output_errors.view(), learning_rate, gradients.view());
+    } else {
+        Matrix::map(outputs.view(), dsigmoid, gradients.view()); // Derivative of outputs (calculating slope)
+        Matrix::multiplyHadamard(gradients.view(), output_errors.view(), gradients.view()); // Element-wise multiplication
+        Matrix::multiplyScalar(gradients.view(), learning_rate, gradients.view());
+    }
     // Scale by learning rate
     // Big Error = Big Change. Small Error = Small Change.
     // Note: We use Hadamard (Element-wise) because each neuron has its own error.
     //   Adjust Weights (Hidden -> Output)
     // Delta = Gradient * Hidden_Transposed
     // Weights_HO = Weights_HO + Delta
-    Matrix hidden_T = hidden.transpose();
-    Matrix weight_ho_deltas = gradients.multiply(hidden_T);
-    weights_ho = weights_ho.add(weight_ho_deltas);
-    bias_o = bias_o.add(gradients); // Adjust the output bias
+    Matrix weight_ho_deltas(output_nodes, hidden_nodes);
+    Matrix::multiply(gradients.view(), hidden.view().transposed(), weight_ho_deltas.view());
+    Matrix::add(weights_ho.view(), weight_ho_deltas.view(), weights_ho.view());
+    Matrix::add(bias_o.view(), gradients.view(), bias_o.view()); // Adjust the output bias
     //   Adjust Weights (Input -> Hidden)
     // Delta = Hidden_Gradient * Input_Transposed
     // Weights_IH = Weights_IH + Delta
     // Calculate Hidden Gradient
-    Matrix hidden_gradients = hidden.map(dsigmoid);
-    hidden_gradients = hidden_gradients.multiplyHadamard(hidden_errors);
-    hidden_gradients = hidden_gradients.multiplyScalar(learning_rate);
+    Matrix hidden_gradients(hidden_nodes, 1);
+    Matrix::map(hidden.view(), dsigmoid, hidden_gradients.view());
+    Matrix::multiplyHadamard(hidden_gradients.view(), hidden_errors.view(), hidden_gradients.view());
+
+    //   Calculate Input Error (only when there are layers below us)
+    // ERROR_INPUT = WEIGHTS_IH_TRANSPOSED * HIDDEN_GRADIENT (before the learning rate)
+    // Same trick as the hidden error, one layer further down. Done before weights_ih changes.
+    if (input_errors.data) {
+        Matrix::multiply(weights_ih.view().transposed(), hidden_gradients.view(), input_errors);
+    }
+    Matrix::multiplyScalar(hidden_gradients.view(), learning_rate, hidden_gradients.view());
 
     // Calculate deltas for input to hidden weights
-    Matrix inputs_T = inputs.transpose();
-    Matrix weight_ih_deltas = hidden_gradients.multiply(inputs_T);
-    weights_ih = weights_ih.add(weight_ih_deltas); // Update input to hidden weights
-    bias_h = bias_h.add(hidden_gradients); // Adjust the hidden bias
+    Matrix weight_ih_deltas(hidden_nodes, input_nodes);
+    Matrix::multiply(hidden_gradients.view(), inputs.transposed(), weight_ih_deltas.view());
+    Matrix::add(weights_ih.view(), weight_ih_deltas.view(), weights_ih.view()); // Update input to hidden weights
+    Matrix::add(bias_h.view(), hidden_gradients.view(), bias_h.view()); // Adjust the hidden bias
 
-}
\ No newline at end of file
+    return loss;
+}
+
+// GRADIENT BUFFER
+NetworkGradients::NetworkGradients(int input_nodes, int hidden_nodes, int output_nodes)
+    : weights_ho(nullptr, 0, 0), bias_o(nullptr, 0, 0),
+      weights_ih(nullptr, 0, 0), bias_h(nullptr, 0, 0),
+      output_layer_size(0)
+{
+    bindViews(input_nodes, hidden_nodes, output_nodes);
+}
+
+// Copying must re-point the views at OUR buffer, not the other one's
+NetworkGradients::NetworkGradients(const NetworkGradients &other)
+    : NetworkGradients(other.weights_ih.cols, other.weights_ih.rows, other.weights_ho.rows)
+{
+    buffer = other.buffer;
+}
+
+NetworkGradients &NetworkGradients::operator=(const NetworkGradients &other) {
+    if (this != &other) {
+        bindViews(other.weights_ih.cols, other.weights_ih.rows, other.weights_ho.rows);
+        buffer = other.buffer;
+    }
+    return *this;
+}
+
+void NetworkGradients::bindViews(int input_nodes, int hidden_nodes, int output_nodes) {
+    int ho = output_nodes * hidden_nodes;
+    int ih = hidden_nodes * input_nodes;
+    output_layer_size = ho + output_nodes;
+    buffer.assign(output_layer_size + ih + hidden_nodes, 0.0);
+
+    double *p = buffer.data();
+    weights_ho = MatrixView(p, output_nodes, hidden_nodes);
+    bias_o = MatrixView(p + ho, output_nodes, 1);
+    weights_ih = MatrixView(p + output_layer_size, hidden_nodes, input_nodes);
+    bias_h = MatrixView(p + output_layer_size + ih, hidden_nodes, 1);
+}
+
+void NetworkGradients::clear() {
+    std::fill(buffer.begin(), buffer.end(), 0.0);
+}
+
+// Compute Gradients
+/*
+    Same math as train(), split in two halves :
+    1. Forward + backward, ADDING the nudges into grads instead of into the weights
+    2. applyGradients() does the actual weight update later
+    This lets us sum the nudges of many samples (mini-batch), or of many
+    processes (data-parallel training), before touching the weights once.
+*/
+void NeuralNetwork::computeGradients(ConstMatrixView inputs, ConstMatrixView targets, NetworkGradients &grads,
+                                     void (*on_output_layer)(void *ctx), void *ctx) {
+    if (inputs.rows != input_nodes || targets.rows != output_nodes || inputs.cols != targets.cols
+        || inputs.cols < 1) {
+        std::cerr << "Input or Target size mismatch!" << std::endl;
+        return;
+    }
+    int batch = inputs.cols; // One sample per column
+
+    // Forward (same as train, the whole batch at once)
+    Matrix hidden(hidden_nodes, batch);
+    Matrix::multiply(weights_ih.view(), inputs, hidden.view());
+    Matrix::addColumn(hidden.view(), bias_h.view(), hidden.view());
+    Matrix::map(hidden.view(), sigmoid, hidden.view());
+
+    Matrix outputs(output_nodes, batch);
+    Matrix::multiply(weights_ho.view(), hidden.view(), outputs.view());
+    Matrix::addColumn(outputs.view(), bias_o.view(), outputs.view());
+
+    // Output layer : gradient = (target - output) * dsigmoid(output)
+    //                softmax head : gradient = target - softmax(logits), fused per sample
+    Matrix output_errors(output_nodes, batch);
+    Matrix gradients(output_nodes, batch);
+    if (output_head == OutputHead::SoftmaxCrossEntropy) {
+        MatrixView errors = output_errors.view();
+        for (int b = 0; b < batch; b++) {
+            Softmax::crossEntropy(&outputs.at(0, b), &targets.at(0, b), output_nodes, &errors.at(0, b),
+                                  targets.row_stride, errors.row_stride);
+        }
+        gradients = output_errors; // No dsigmoid : the error is the gradient
+    } else {
+        Matrix::map(outputs.view(), sigmoid, outputs.view());
+        Matrix::subtract(targets, outputs.view(), output_errors.view());
+        Matrix::map(outputs.view(), dsigmoid, gradients.view());
+        Matrix::multiplyHadamard(gradients.view(), output_errors.view(), gradients.view());
+    }
+
+    // Accumulate output layer : grads += gradient * hidden_T
+    // (one multiply sums over the whole batch, the bias gets the row sums)
+    Matrix delta_ho(output_nodes, hidden_nodes);
+    Matrix::multiply(gradients.view(), hidden.view().transposed(), delta_ho.view());
+    Matrix::add(grads.weights_ho, delta_ho.view(), grads.weights_ho);
+    for (int i = 0; i < output_nodes; i++) {
+        double sum = 0.0;
+        for (int b = 0; b < batch; b++) sum += gradients.at(i, b);
+        grads.bias_o.at(i, 0) += sum;
+    }
+
+    if (on_output_layer) {
+        on_output_layer(ctx); // Output block is final, the caller may start sending it
+    }
+
+    // Everything below (the bigger half of the backward pass) runs while it travels
+
+    // Hidden error, sent back through the (not yet updated) weights
+    Matrix hidden_errors(hidden_nodes, batch);
+    Matrix::multiply(weights_ho.view().transposed(), output_errors.view(), hidden_errors.view());
+
+    // Hidden layer : gradient = hidden_error * dsigmoid(hidden)
+    Matrix hidden_gradients(hidden_nodes, batch);
+    Matrix::map(hidden.view(), dsigmoid, hidden_gradients.view());
+    Matrix::multiplyHadamard(hidden_gradients.view(), hidden_errors.view(), hidden_gradients.view());
+
+    // Accumulate hidden layer : grads += hidden_gradient * inputs_T
+    Matrix delta_ih(hidden_nodes, input_nodes);
+    Matrix::multiply(hidden_gradients.view(), inputs.transposed(), delta_ih.view());
+    Matrix::add(grads.weights_ih, delta_ih.view(), grads.weights_ih);
+    for (int i = 0; i < hidden_nodes; i++) {
+        double sum = 0.0;
+        for (int b = 0; b < batch; b++) sum += hidden_gradients.at(i, b);
+        grads.bias_h.at(i, 0) += sum;
+    }
+}
+
+// Apply Gradients
+// Weights = Weights + LearningRate * scale * Gradients
+// scale is usually 1 / batch_size so the step size does not depend on the batch size
+void NeuralNetwork::applyGradients(const NetworkGradients &grads, double scale) {
+    double step = learning_rate * scale;
+    Matrix* params[4] = {&weights_ho, &bias_o, &weights_ih, &bias_h};
+    MatrixView deltas[4] = {grads.weights_ho, grads.bias_o, grads.weights_ih, grads.bias_h};
+    for (int p = 0; p < 4; p++) {
+        MatrixView w = params[p]->view();
+        if (deltas[p].rows != w.rows || deltas[p].cols != w.cols) {
+            std::cerr << "Error: Gradient shape does not match the network." << std::endl;
+            return;
+        }
+        for (int i = 0; i < w.rows; i++) {
+            for (int j = 0; j < w.cols; j++) {
+                w.at(i, j) += step * deltas[p].at(i, j);
+            }
+        }
+    }
+}
+
+// Flat Parameters
+// Layout matches NetworkGradients : [ weights_ho | bias_o | weights_ih | bias_h ]
+int NeuralNetwork::parameterCount() const {
+    return output_nodes * hidden_nodes + output_nodes + hidden_nodes * input_nodes + hidden_nodes;
+}
+
+void NeuralNetwork::copyParametersTo(double *out) const {
+    const Matrix* params[4] = {&weights_ho, &bias_o, &weights_ih, &bias_h};
+    for (const Matrix *m : params) {
+        for (int i = 0; i < m->getRows(); i++) {
+            for (int j = 0; j < m->getCols(); j++) {
+                *out++ = m->at(i, j);
+            }
+        }
+    }
+}
+
+void NeuralNetwork::setParametersFrom(const double *in) {
+    Matrix* params[4] = {&weights_ho, &bias_o, &weights_ih, &bias_h};
+    for (Matrix *m : params) {
+        for (int i = 0; i < m->getRows(); i++) {
+            for (int j = 0; j < m->getCols(); j++) {
+                m->at(i, j) = *in++;
+            }
+        }
+    }
+}
+
+// Freeze
+// Everything the frozen model needs is copied and repacked here, once
+InferenceModel NeuralNetwork::freeze() const {
+    return InferenceModel(*this);
+}
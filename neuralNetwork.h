@@ -4,13 +4,56 @@
 #include <vector>
 #include "matrix.h" // Matrix engine 
 
+class InferenceModel; // Frozen, read-only copy for serving (inferenceModel.h)
+
+// Gradient Buffer
+/*
+    Summed weight changes ("nudges" before the learning rate) for a network,
+    with the same shapes as the weights it belongs to.
+    All four blocks live back to back in ONE flat buffer so the whole thing
+    (or one layer of it) can be shipped to other processes in a single message.
+    Order is the order backpropagation finishes them : output layer first.
+    [ weights_ho | bias_o | weights_ih | bias_h ]
+*/
+class NetworkGradients {
+public:
+    std::vector<double> buffer;
+    MatrixView weights_ho, bias_o; // Output layer block
+    MatrixView weights_ih, bias_h; // Hidden layer block
+    int output_layer_size; // Numbers in the output layer block (starts at 0)
+
+    NetworkGradients(int input_nodes, int hidden_nodes, int output_nodes);
+    NetworkGradients(const NetworkGradients &other);
+    NetworkGradients &operator=(const NetworkGradients &other);
+    void clear(); // Back to all zeros
+
+private:
+    void bindViews(int input_nodes, int hidden_nodes, int output_nodes);
+};
+
+// Output Layer
+/*
+    Sigmoid             : every output squashed to 0-1 on its own, trained on squared error
+                          (the original head, good for XOR style yes/no outputs)
+    SoftmaxCrossEntropy : outputs are probabilities that add up to 1, trained on
+                          cross-entropy (softmax.h). One right answer out of many (digits).
+*/
+enum class OutputHead {
+    Sigmoid,
+    SoftmaxCrossEntropy
+};
+
 class NeuralNetwork {
+    // Lock-free trainer that updates the weights in place from many threads (hogwild.h)
+    friend class HogwildTrainer;
+
 private:
     // 1. Architecture Configurations
     int input_nodes;
     int hidden_nodes;
     int output_nodes;
     double learning_rate; // How fast it learns
+    OutputHead output_head; // What the output layer does with its weighted sums
 
     // 2. Memory (Matrices)
     Matrix weights_ih; // Weights from Input to Hidden
@@ -20,25 +63,84 @@ private:
     Matrix bias_h; // Bias for Hidden Layer
     Matrix bias_o; // Bias for Output Layer
 
+    // Shared body of every train() : uses targets when label < 0, else the class index
+    double backpropagate(ConstMatrixView inputs, ConstMatrixView targets, int label, MatrixView input_errors);
+
+    // Output layer activation, in place on the weighted sums (output_nodes x B)
+    void activateOutputs(MatrixView outputs) const;
+
+public:
     // 4. Activation Function
+    // (public so packed / fused trainers use exactly the same math)
     static double sigmoid(double x);
 
     // 5. Derivative of Activation Function
     static double dsigmoid(double y);
 
-public:
     // Cosntructor : Initialize the brain size
-    NeuralNetwork(int input_nodes, int hidden_nodes, int output_nodes);
+    NeuralNetwork(int input_nodes, int hidden_nodes, int output_nodes,
+                  OutputHead output_head = OutputHead::Sigmoid);
 
     // Prediction Engine
     // Takes a standard C++ vector as input (list of numbers
     // Returns a standard C++ vector as output (list of probabilities)
-    std::vector<double> feedForward(std::vector<double> input_array);
+    std::vector<double> feedForward(const std::vector<double> &input_array);
+
+    // Prediction Engine (no copies)
+    // inputs  : input_nodes x B view (B samples, one per column) of the caller's memory
+    // outputs : output_nodes x B view the results are written into
+    // eg. one image : ConstMatrixView::column(pixels), MatrixView::column(out, 10)
+    // Returns false on a size mismatch.
+    bool feedForward(ConstMatrixView inputs, MatrixView outputs);
 
     // Training function
     // Input - data to look at
     // Target - answer it should have given
-    void train(std::vector<double> input_array, std::vector<double> target_array);
+    void train(const std::vector<double> &input_array, const std::vector<double> &target_array);
+
+    // Training function (no copies)
+    // inputs : input_nodes x 1 view, targets : output_nodes x 1 view
+    void train(ConstMatrixView inputs, ConstMatrixView targets);
+
+    // Training function for a network that sits on top of other layers (eg. ConvNet)
+    // Same update, and also writes the error of every INPUT (input_nodes x 1) so the
+    // layers below can keep backpropagating. Worked out through the old weights_ih.
+    void train(ConstMatrixView inputs, ConstMatrixView targets, MatrixView input_errors);
+
+    // Training function with the answer as a class index (eg. MNISTParser::loadLabelIndices)
+    // No one-hot target is built. Returns this sample's loss :
+    // cross-entropy for the softmax head, sum of squared errors for the sigmoid head.
+    double train(const std::vector<double> &input_array, int label);
+    double train(ConstMatrixView inputs, int label);
+
+    // Split Training (for mini-batches and multi-process training)
+    // computeGradients : backpropagate a batch (inputs input_nodes x B, targets output_nodes x B,
+    //                    one sample per column) and ADD its summed nudges into grads
+    //                    (no learning rate, weights untouched)
+    //                    on_output_layer(ctx) fires as soon as the output layer block of
+    //                    the WHOLE batch is final, before any hidden layer work
+    // applyGradients   : weights += learning_rate * scale * grads
+    void computeGradients(ConstMatrixView inputs, ConstMatrixView targets, NetworkGradients &grads,
+                          void (*on_output_layer)(void *ctx) = nullptr, void *ctx = nullptr);
+    void applyGradients(const NetworkGradients &grads, double scale);
+
+    // Parameters as one flat list (same order as NetworkGradients)
+    // Used to copy a network between processes
+    int parameterCount() const;
+    void copyParametersTo(double *out) const;
+    void setParametersFrom(const double *in);
+
+    // Freeze : pack the current weights into an immutable InferenceModel
+    // (the network itself is untouched and can keep training)
+    InferenceModel freeze() const;
+
+    // Architecture queries
+    int getInputNodes() const { return input_nodes; }
+    int getHiddenNodes() const { return hidden_nodes; }
+    int getOutputNodes() const { return output_nodes; }
+    OutputHead getOutputHead() const { return output_head; }
+    double getLearningRate() const { return learning_rate; }
+    void setLearningRate(double rate) { learning_rate = rate; }
 
 };
 
@@ -0,0 +1,72 @@
+#include "softmax.h"
+#include <cmath> // For exp, log
+
+namespace Softmax {
+
+    void probabilities(double *values, int n, int stride) {
+        if (n <= 0) return;
+        // 1. Biggest logit (so every exp below is <= 1)
+        double max_logit = values[0];
+        for (int i = 1; i < n; i++) {
+            if (values[i * stride] > max_logit) max_logit = values[i * stride];
+        }
+        // 2. exp and running sum
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) {
+            values[i * stride] = exp(values[i * stride] - max_logit);
+            sum += values[i * stride];
+        }
+        // 3. Normalize (one division, n multiplies)
+        double inv = 1.0 / sum;
+        for (int i = 0; i < n; i++) {
+            values[i * stride] *= inv;
+        }
+    }
+
+    double crossEntropy(const double *logits, const double *target, int n, double *errors,
+                        int target_stride, int stride) {
+        if (n <= 0) return 0.0;
+        // Pass 1 : max, and the target-weighted logits for the loss
+        double max_logit = logits[0];
+        double target_sum = 0.0, target_dot = 0.0;
+        for (int i = 0; i < n; i++) {
+            double y = target[i * target_stride];
+            double z = logits[i * stride];
+            if (z > max_logit) max_logit = z;
+            target_sum += y;
+            target_dot += y * z;
+        }
+        // Pass 2 : unnormalized probabilities straight into the error buffer
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) {
+            errors[i * stride] = exp(logits[i * stride] - max_logit);
+            sum += errors[i * stride];
+        }
+        // Pass 3 : error = y - p
+        double inv = 1.0 / sum;
+        for (int i = 0; i < n; i++) {
+            errors[i * stride] = target[i * target_stride] - errors[i * stride] * inv;
+        }
+        // -sum y_i (z_i - m - log(sum))
+        return (max_logit + log(sum)) * target_sum - target_dot;
+    }
+
+    double crossEntropy(const double *logits, int label, int n, double *errors) {
+        if (n <= 0 || label < 0 || label >= n) return 0.0;
+        double max_logit = logits[0];
+        for (int i = 1; i < n; i++) {
+            if (logits[i] > max_logit) max_logit = logits[i];
+        }
+        double sum = 0.0;
+        for (int i = 0; i < n; i++) {
+            errors[i] = exp(logits[i] - max_logit);
+            sum += errors[i];
+        }
+        double inv = 1.0 / sum;
+        for (int i = 0; i < n; i++) {
+            errors[i] = (i == label ? 1.0 : 0.0) - errors[i] * inv;
+        }
+        return max_logit + log(sum) - logits[label];
+    }
+
+} // namespace Softmax
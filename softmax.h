@@ -0,0 +1,48 @@
+#ifndef SOFTMAX_H
+#define SOFTMAX_H
+
+/*
+    The Problem : Sigmoid + squared error learns slowly when it is sure and wrong.
+    The output gradient is (target - output) * dsigmoid(output), and dsigmoid is
+    almost 0 when the output is close to 0 or 1. A digit the network is CONFIDENTLY
+    wrong about barely moves the weights, exactly when we want the biggest change.
+
+    The Fix : Softmax + cross-entropy
+    Softmax turns the raw output sums ("logits" z) into probabilities that add up to 1:
+        p_i = exp(z_i) / sum_j exp(z_j)
+    and cross-entropy scores them with  loss = -sum_i y_i * log(p_i).
+    Put together, the gradient of the loss with respect to the logits is simply p - y:
+    no dsigmoid, so the more wrong the guess, the bigger the step.
+
+    NUMERICAL STABILITY
+    exp(1000) overflows. Softmax does not change if every logit moves by the same
+    amount, so we subtract the biggest logit m first : every exp() is then at most 1.
+    The loss is worked out from the same pieces without taking log of a tiny p:
+        -log(p_y) = m + log(sum_j exp(z_j - m)) - z_y
+
+    FUSED KERNEL
+    crossEntropy() does softmax, loss and gradient in 3 tight passes over the n logits
+    (max, exp + sum, normalize + subtract) writing one buffer, and calls log() once.
+
+    The error it writes follows NeuralNetwork's convention, error = target - output,
+    i.e. y - p (the negative gradient), so the usual "weights += learning_rate * ..." applies.
+*/
+
+namespace Softmax {
+
+    // In place : n logits (stride apart) become n probabilities
+    void probabilities(double *values, int n, int stride = 1);
+
+    // Fused softmax + cross-entropy with a one-hot (or any probability) target
+    // logits / errors : n values (stride apart, eg. one column of a batch), errors = y - p
+    // target : n values (target_stride apart)
+    // Returns the loss -sum y_i log(p_i).
+    double crossEntropy(const double *logits, const double *target, int n, double *errors,
+                        int target_stride = 1, int stride = 1);
+
+    // Same with the class index as the label (eg. MNISTParser::loadLabelIndices)
+    double crossEntropy(const double *logits, int label, int n, double *errors);
+
+} // namespace Softmax
+
+#endif // SOFTMAX_H
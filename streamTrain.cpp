@@ -0,0 +1,100 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include "neuralNetwork.h"
+#include "idxReader.h"
+
+// Out-of-core training on any IDX image / label pair
+/*
+    usage : ./streamTrain images.idx labels.idx [classes] [epochs] [window]
+    Images can be any IDX element type and shape (every record is flattened),
+    labels are one integer class per record.
+    Only `window` records are in memory at any time, so the dataset can be far
+    bigger than RAM : memory use stays the same for 60 thousand or 60 million samples.
+    Needs POSIX file reads (Linux, macOS); the page cache hints are Linux only.
+*/
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " images.idx labels.idx [classes] [epochs] [window]" << std::endl;
+        return 1;
+    }
+    std::string image_file = argv[1];
+    std::string label_file = argv[2];
+    int classes = argc > 3 ? std::atoi(argv[3]) : 10;
+    int epochs = argc > 4 ? std::atoi(argv[4]) : 1;
+    size_t window = argc > 5 ? std::atol(argv[5]) : 4096;
+
+    // Byte pixels are normalized to 0-1 like MNISTParser does, other types are used as they are
+    IdxHeader header;
+    if (!IdxReader::readHeader(image_file, header))
+        return 1;
+    double scale = header.type == IdxType::UInt8 ? 1.0 / 255.0 : 1.0;
+
+    IdxStream images(image_file, window, scale);
+    IdxStream labels(label_file, window);
+    if (!images.isOpen() || !labels.isOpen())
+        return 1;
+    if (images.getHeader().recordCount() != labels.getHeader().recordCount() || labels.getHeader().recordSize() != 1)
+    {
+        std::cerr << "[ERROR] Images and labels do not match up." << std::endl;
+        return 1;
+    }
+
+    int inputs = (int)images.getHeader().recordSize();
+    NeuralNetwork nn(inputs, 128, classes);
+    std::cout << "Topology: " << inputs << " -> 128 -> " << classes << std::endl;
+    std::cout << "Records: " << images.getHeader().recordCount() << " (window " << window << ")" << std::endl;
+
+    std::vector<double> target(classes, 0.0); // One-hot target, reused
+    std::vector<double> out(classes);         // Network output, reused
+    for (int e = 0; e < epochs; e++)
+    {
+        size_t seen = 0;
+        int correct = 0;
+        images.rewind();
+        labels.rewind();
+        size_t count;
+        while ((count = images.next()) > 0)
+        {
+            if (labels.next() != count)
+            {
+                std::cerr << "[ERROR] Label stream ended early." << std::endl;
+                return 1;
+            }
+            ConstMatrixView rows = images.chunk();
+            ConstMatrixView answers = labels.chunk();
+
+            for (size_t r = 0; r < count; r++)
+            {
+                int label = (int)answers.at((int)r, 0);
+                if (label < 0 || label >= classes)
+                    continue; // Skip labels the network has no output for
+
+                // Row r of the window, seen as a column : no copy
+                ConstMatrixView sample(&rows.at((int)r, 0), inputs, 1, 1, 1);
+
+                // Running accuracy on samples before training on them
+                nn.feedForward(sample, MatrixView::column(out.data(), classes));
+                int guess = 0;
+                for (int c = 1; c < classes; c++)
+                    if (out[c] > out[guess]) guess = c;
+                if (guess == label)
+                    correct++;
+
+                target[label] = 1.0;
+                nn.train(sample, ConstMatrixView::column(target));
+                target[label] = 0.0;
+            }
+            seen += count;
+            std::cout << "Epoch " << e + 1 << " | Record " << seen << " / " << images.getHeader().recordCount()
+                      << " | Running Accuracy: " << (100.0 * correct / seen) << "%  \r" << std::flush;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "SUCCESS :: Streaming Training Complete." << std::endl;
+    return 0;
+}
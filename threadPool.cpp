@@ -0,0 +1,202 @@
+#include "threadPool.h"
+#include <algorithm> // For std::min, std::max
+#include <cstdlib>   // For getenv
+#ifdef __linux__
+#include <pthread.h> // For pthread_setaffinity_np
+#include <sched.h>   // For sched_getaffinity, cpu_set_t
+#endif
+
+// Which pool queue the current thread owns (-1 = not a pool worker)
+static thread_local int current_worker = -1;
+static thread_local const ThreadPool *current_pool = nullptr;
+
+ThreadPool::ThreadPool(int workers)
+    : queues(std::max(1, workers)), queued(0), next_queue(0), stopping(false), pinned(false)
+{
+    for (int i = 0; i < workers; i++) {
+        this->workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : workers) {
+        t.join();
+    }
+}
+
+ThreadPool &ThreadPool::global() {
+    // Built on first use, lives until the program ends
+    // NN_NUM_THREADS overrides the core count (eg. to share a machine)
+    static ThreadPool pool([] {
+        int threads = (int)std::thread::hardware_concurrency();
+        const char *env = std::getenv("NN_NUM_THREADS");
+        if (env && std::atoi(env) > 0) threads = std::atoi(env);
+        return std::max(0, threads - 1);
+    }());
+    return pool;
+}
+
+void ThreadPool::push(int home, const Task &task) {
+    {
+        std::lock_guard<std::mutex> guard(queues[home].lock);
+        queues[home].tasks.push_back(task);
+    }
+    queued.fetch_add(1);
+    {
+        // Taking the sleep lock orders this push before a worker's "is there work?" check
+        std::lock_guard<std::mutex> guard(sleep_lock);
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::tryRun(int home) {
+    Task task = {nullptr, 0, 0, nullptr};
+    bool found = false;
+    int n = (int)queues.size();
+
+    // 1. Own queue, newest first (its data is most likely still in cache)
+    if (home >= 0) {
+        std::lock_guard<std::mutex> guard(queues[home].lock);
+        if (!queues[home].tasks.empty()) {
+            task = queues[home].tasks.back();
+            queues[home].tasks.pop_back();
+            found = true;
+        }
+    }
+    // 2. Steal the oldest piece from somebody else
+    for (int i = 0; i < n && !found; i++) {
+        int victim = (std::max(home, 0) + 1 + i) % n;
+        if (victim == home) continue;
+        std::lock_guard<std::mutex> guard(queues[victim].lock);
+        if (!queues[victim].tasks.empty() && !queues[victim].tasks.front().home_only) {
+            task = queues[victim].tasks.front();
+            queues[victim].tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    queued.fetch_sub(1);
+    (*task.body)(task.begin, task.end);
+    task.pending->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void ThreadPool::workerLoop(int id) {
+    current_worker = id;
+    current_pool = this;
+    while (true) {
+        if (tryRun(id)) continue;
+
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+void ThreadPool::parallelFor(long count, long grain, const std::function<void(long, long)> &body,
+                             int max_tasks) {
+    if (count <= 0) return;
+    grain = std::max(1L, grain);
+
+    // How many pieces : no smaller than grain, no more than the threads can use
+    // (a few extra per thread so stealing can even out uneven pieces)
+    long tasks = std::min(count / grain, (long)size() * 4);
+    if (max_tasks > 0) tasks = std::min(tasks, (long)max_tasks);
+    if (tasks <= 1 || workers.empty()) {
+        body(0, count);
+        return;
+    }
+
+    // Pieces go to our own queue if we are a worker, else spread round robin
+    int home = (current_pool == this) ? current_worker : -1;
+    std::atomic<long> pending(tasks);
+    long per_task = count / tasks;
+    long extra = count % tasks;
+    long begin = 0;
+    bool blocks = home < 0 && pinned.load(); // Slice w of the range to worker w
+    Task first = {&body, 0, 0, &pending};
+    for (long t = 0; t < tasks; t++) {
+        long end = begin + per_task + (t < extra ? 1 : 0);
+        Task task = {&body, begin, end, &pending};
+        if (t == 0) {
+            first = task; // Keep one piece for ourselves
+        } else {
+            int target = home >= 0 ? home
+                       : blocks    ? (int)(t * (long)queues.size() / tasks)
+                                   : (int)(next_queue.fetch_add(1) % queues.size());
+            push(target, task);
+        }
+        begin = end;
+    }
+
+    body(first.begin, first.end);
+    pending.fetch_sub(1, std::memory_order_release);
+
+    // Help with any work (ours or not) until our pieces are finished
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!tryRun(home)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool ThreadPool::pinWorkers() {
+    std::lock_guard<std::mutex> guard(pin_lock);
+    if (pinned.load()) return true;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+    std::vector<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+    }
+    if (cpus.empty()) return false;
+
+    // More workers than CPUs (NN_NUM_THREADS) : wrap around
+    for (size_t w = 0; w < workers.size(); w++) {
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpus[(w + 1) % cpus.size()], &one);
+        if (pthread_setaffinity_np(workers[w].native_handle(), sizeof(one), &one) != 0) return false;
+    }
+    pinned.store(true);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ThreadPool::forEachWorker(long count, const std::function<void(long, long)> &body) {
+    if (count <= 0) return;
+    long n = (long)workers.size();
+    if (n == 0) {
+        body(0, count);
+        return;
+    }
+
+    // Fewer items than workers : some workers get an empty slice, which is skipped
+    std::atomic<long> pending(std::min(n, count));
+    for (long w = 0; w < n; w++) {
+        Task task = {&body, w * count / n, (w + 1) * count / n, &pending, true};
+        if (task.begin < task.end) push((int)w, task);
+    }
+    {
+        // push() woke ONE worker, which may not own a slice : wake them all
+        std::lock_guard<std::mutex> guard(sleep_lock);
+    }
+    wake.notify_all();
+
+    int home = (current_pool == this) ? current_worker : -1;
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!tryRun(home)) {
+            std::this_thread::yield();
+        }
+    }
+}
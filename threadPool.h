@@ -0,0 +1,99 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/*
+    The Problem : Starting threads is expensive.
+    Creating a std::thread costs tens of microseconds. A 128 x 784 product takes
+    about that long in total, so spawning threads per multiply would eat the gain.
+
+    The Fix : A pool of threads that are started ONCE and wait for work.
+    parallelFor(count, grain, body) cuts [0, count) into pieces of at least `grain`
+    and the pool runs body(begin, end) on each piece. The calling thread helps too,
+    and returns when every piece is done.
+
+    WORK STEALING
+    Every worker has its own queue of pieces. It takes work from the BACK of its own
+    queue, and when that is empty it steals from the FRONT of somebody else's.
+    - No single shared queue that every thread fights over
+    - A thread waiting for its pieces runs other pieces meanwhile, so a parallelFor
+      inside a parallelFor (eg. a Matrix kernel inside a per-model loop) cannot deadlock
+
+    PINNING (opt-in, Linux)
+    By default the OS moves the workers between cores as it likes. pinWorkers() fixes
+    worker w to one CPU for good, and from then on a parallelFor started outside the
+    pool deals its pieces out in contiguous blocks (the first 1/n of the range to
+    worker 0, the next 1/n to worker 1, ...) instead of round robin. forEachWorker()
+    splits a range the same way but never lets a piece be stolen, so "worker w wrote
+    the w-th slice" is guaranteed (used by MatrixStorage's NUMA first touch).
+    Stealing still evens out uneven pieces in parallelFor, so there a slice usually,
+    not always, runs on the worker that owns it.
+*/
+
+class ThreadPool {
+private:
+    struct Task {
+        const std::function<void(long, long)> *body;
+        long begin, end;
+        std::atomic<long> *pending; // Pieces of this parallelFor still running
+        bool home_only = false;     // Never stolen : only the queue's own worker runs it
+    };
+
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<WorkerQueue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<long> queued;        // Pieces waiting in any queue
+    std::atomic<unsigned> next_queue; // Round robin for callers outside the pool
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    bool stopping;
+    std::mutex pin_lock;
+    std::atomic<bool> pinned;
+
+    void workerLoop(int id);
+    bool tryRun(int home); // Run one piece (own queue first, then steal). False if none found.
+    void push(int home, const Task &task);
+
+public:
+    // `workers` background threads (the caller of parallelFor is one more)
+    explicit ThreadPool(int workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Shared pool : one worker per core (or NN_NUM_THREADS), minus the calling thread
+    static ThreadPool &global();
+
+    // Threads that can work on a parallelFor at once (workers + caller)
+    int size() const { return (int)workers.size() + 1; }
+
+    // Run body(begin, end) over [0, count) in pieces of at least `grain` items,
+    // using at most `max_tasks` pieces (0 = as many as useful).
+    // Small ranges (count <= grain) run directly on the calling thread.
+    void parallelFor(long count, long grain, const std::function<void(long, long)> &body,
+                     int max_tasks = 0);
+
+    // Pin worker w to the (w + 1)-th CPU this process may use (the first is left to the
+    // calling thread, which is never pinned). Once is enough, later calls just report.
+    // False when pinning is not supported (not Linux) or failed.
+    bool pinWorkers();
+    bool isPinned() const { return pinned.load(); }
+
+    // Run body(begin, end) over [0, count) in one contiguous slice per worker,
+    // slice w ON worker w (never stolen). No workers : the caller runs it all.
+    void forEachWorker(long count, const std::function<void(long, long)> &body);
+};
+
+#endif // THREAD_POOL_H
@@ -5,7 +5,8 @@
 #include <cstdlib>
 #include <iomanip> // For std::setw, std::setprecision
 
-#include "NeuralNetwork.h"
+#include "neuralNetwork.h"
+#include "modelExporter.h"
 
 // Helper to print a progress bar
 void printProgressBar(int current, int total) {
@@ -87,5 +88,11 @@ int main() {
     }
     std::cout << "===================================================" << std::endl;
 
+    // 5. Export : bake the trained weights into a header that can be compiled into
+    // any program (no Matrix, no files, no heap) with #include "xorModel.h"
+    if (ModelExporter::exportHeader(nn, "xorModel.h", "xorModel")) {
+        std::cout << "[EXPORT] Model written to xorModel.h" << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <iomanip>
+
+#include "neuralNetwork.h"
+#include "multiModel.h"
+
+// Learning rate / seed sweep on XOR
+/*
+    32 copies of the 2-4-1 network from xor.cpp (4 learning rates x 8 seeds)
+    trained side by side by one MultiModelTrainer instead of 32 separate runs.
+*/
+
+int main() {
+    std::cout << "   XOR SWEEP: 32 PACKED 2-4-1 MODELS   " << std::endl;
+
+    std::vector<std::vector<double>> inputs = {
+        {0.0, 0.0}, {0.0, 1.0}, {1.0, 0.0}, {1.0, 1.0}
+    };
+    std::vector<std::vector<double>> targets = {
+        {0.0}, {1.0}, {1.0}, {0.0}
+    };
+
+    // 1. Build the candidates
+    double rates[4] = {0.05, 0.1, 0.5, 1.0};
+    std::vector<NeuralNetwork> candidates;
+    for (int r = 0; r < 4; r++) {
+        for (int seed = 0; seed < 8; seed++) {
+            std::srand(seed); // Same seeds for every learning rate
+            NeuralNetwork nn(2, 4, 1);
+            nn.setLearningRate(rates[r]);
+            candidates.push_back(nn);
+        }
+    }
+
+    // 2. Train them all at once (one pattern per step, like xor.cpp)
+    MultiModelTrainer sweep(candidates);
+    int epochs = 20000;
+    for (int e = 0; e < epochs; e++) {
+        sweep.trainEpoch(inputs, targets, 1);
+    }
+
+    // 3. Report
+    std::vector<ModelMetrics> metrics = sweep.evaluate(inputs, targets);
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << " MODEL | RATE   | SEED | LOSS   | ACCURACY" << std::endl;
+    for (int k = 0; k < sweep.modelCount(); k++) {
+        std::cout << "  " << std::setw(3) << k << "  | " << rates[k / 8] << " |  " << k % 8
+                  << "   | " << metrics[k].loss << " | " << metrics[k].accuracy * 100.0 << "%" << std::endl;
+    }
+    std::cout << "===================================================" << std::endl;
+    return 0;
+}